@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Word-at-a-time (SWAR) helpers for ASCII fast paths.
+// Portable: 8 bytes are checked with a few integer operations.
+namespace ppx::utf8::ascii {
+    using u64 = uint64_t;
+
+    constexpr u64 Ones = 0x0101010101010101ull;
+    constexpr u64 Highs = 0x8080808080808080ull;
+
+    inline u64 load64(char const *const ptr) noexcept {
+        u64 w;
+        std::memcpy(&w, ptr, sizeof(w));
+        return w;
+    }
+
+    /// Returns number of leading ASCII bytes (< 0x80).
+    inline std::size_t prefix(char const *const ptr, std::size_t const n) noexcept {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            if (load64(ptr + i) & Highs)
+                break;
+        while (i < n && static_cast<unsigned char>(ptr[i]) < 0x80)
+            i++;
+        return i;
+    }
+
+    /// Returns number of leading printable ASCII bytes (0x20 - 0x7e).
+    inline std::size_t printable_prefix(char const *const ptr, std::size_t const n) noexcept {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            auto const w = load64(ptr + i);
+            auto const del = w ^ (Ones * 0x7f);
+            auto const bad = (w & Highs)
+                             | ((w - Ones * 0x20) & ~w & Highs)
+                             | ((del - Ones) & ~del & Highs);
+            if (bad)
+                break;
+        }
+        for (; i < n; i++) {
+            auto const c = static_cast<unsigned char>(ptr[i]);
+            if (c < 0x20 || c > 0x7e)
+                break;
+        }
+        return i;
+    }
+}
@@ -0,0 +1,37 @@
+#include "cursor.h"
+
+namespace ppx::utf8 {
+    // Fetch utf8-scope for code-point at index;
+    // After success cursor is AFTER that code-point.
+    scope cursor::
+    operator[](uint const idx) noexcept {
+        if (idx >= uint(doc_->len_))
+            return {};
+
+        // Stepping forward from here is cheaper than seeking
+        // only if we are close enough.
+        if (idx < idx_ || (doc_->indexed() && idx - idx_ > document::IndexStride)) {
+            UTF8SPAN_COUNT(rewinds, 1);
+            ptr_ = doc_->seek(idx);
+            idx_ = idx;
+        }
+        UTF8SPAN_COUNT(steps, idx - idx_);
+        while (idx_ < idx) {
+            ptr_ += scope::sequence_size(ptr_, doc_->sentinel_);
+            idx_++;
+        }
+        return next();
+    }
+
+    bool cursor::
+    skip(uint const n) noexcept {
+        if (n > uint(doc_->len_) - idx_)
+            return false;
+
+        for (uint i = 0; i < n; i++)
+            ptr_ += scope::sequence_size(ptr_, doc_->sentinel_);
+        idx_ += n;
+        UTF8SPAN_COUNT(steps, n);
+        return true;
+    }
+}
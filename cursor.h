@@ -0,0 +1,72 @@
+#pragma once
+
+#include "document.h"
+
+namespace ppx::utf8 {
+
+    /// Cheap, per-thread iteration state over a shared document.
+    class cursor {
+        document const *doc_;
+        char const *ptr_;
+        uint idx_{};        // code-point index
+    public:
+        cursor() = delete;
+        ~cursor() = default;
+        cursor(cursor const&) = default;
+        cursor& operator=(cursor const&) = default;
+
+        explicit cursor(document const& doc) noexcept
+                : doc_{&doc}, ptr_{doc.addr_} {
+        }
+
+        /// Returns index of code-point under cursor.
+        [[nodiscard]] uint index() const noexcept {
+            return idx_;
+        }
+
+        /// Rewind cursor to beginning of document.
+        void begin() noexcept {
+            UTF8SPAN_COUNT(rewinds, 1);
+            ptr_ = doc_->addr_;
+            idx_ = 0;
+        }
+
+        /// Rewind cursor to after end of document.
+        void end() noexcept {
+            ptr_ = doc_->seek(uint(doc_->len_));
+            idx_ = uint(doc_->len_);
+        }
+
+        /// Fetch utf8-scope for code-point at index;
+        /// After success cursor is AFTER that code-point.
+        scope operator[](uint idx) noexcept;
+
+        /// Get scope for current utf8.
+        /// After success cursor is moved forward (to the next utf8).
+        scope next() noexcept {
+            auto rv = scope::forward(ptr_, doc_->sentinel_);
+            if (rv.valid_chars()) {
+                UTF8SPAN_COUNT(steps, 1);
+                idx_ += 1;
+            }
+            return rv;
+        }
+
+        /// Get scope for previous utf8.
+        /// After success cursor in moved to the utf8's position.
+        scope prev() noexcept {
+            auto rv = scope::backward(ptr_, doc_->addr_);
+            if (rv.valid_chars()) {
+                UTF8SPAN_COUNT(steps, 1);
+                idx_ -= 1;
+            }
+            return rv;
+        }
+
+        /// Skips passed number of code-points. \n
+        /// If something goes wrong the cursor remains unchanged.
+        /// \param n - number code-points to skip.
+        /// \return True if the operation was successful, False otherwise.
+        bool skip(uint n) noexcept;
+    };
+}
@@ -0,0 +1,130 @@
+#include "document.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ppx::utf8 {
+    document::document(std::string str, bool const indexed)
+            : store_{std::move(str)} {
+        addr_ = store_.data();
+        size_ = int(store_.size());
+        sentinel_ = addr_ + size_;
+        build(indexed);
+    }
+
+    document::document(char const *const ptr, uint const size, bool const indexed)
+            : scope(ptr, int(size)), sentinel_{ptr + size} {
+        build(indexed);
+    }
+
+    // Counts code-points and builds index (if requested).
+    void document::
+    build(bool const indexed) {
+        if (indexed) {
+            index_.reserve(size_ / IndexStride + 1);
+            index_.push_back(0);
+        }
+
+        auto ptr = addr_;
+        uint n = 0;
+        while (ptr < sentinel_) {
+            ptr += sequence_size(ptr, sentinel_);
+            if (++n % IndexStride == 0 && indexed)
+                index_.push_back(uint(ptr - addr_));
+        }
+        len_ = int(n);
+    }
+
+    // Returns address of code-point at index (nullptr if out of range).
+    char const *document::
+    seek(uint const idx) const noexcept {
+        if (idx > uint(len_))
+            return nullptr;
+
+        auto ptr = addr_;
+        uint i = 0;
+        if (!index_.empty()) {
+            auto const k = std::min(std::size_t(idx / IndexStride), index_.size() - 1);
+            ptr += index_[k];
+            i = uint(k) * IndexStride;
+        }
+        for (; i < idx; i++)
+            ptr += sequence_size(ptr, sentinel_);
+        return ptr;
+    }
+
+    // Fetch utf8-scope for code-point at index.
+    scope document::
+    operator[](uint const idx) const noexcept {
+        if (idx >= uint(len_))
+            return {};
+        auto ptr = seek(idx);
+        return forward(ptr, sentinel_);
+    }
+
+    // Fetch multi-utf8-scope of a specific length.
+    scope document::
+    subspan(uint const idx, uint const len) const noexcept {
+        if (len == 0 || idx >= uint(len_) || len > uint(len_) - idx)
+            return {};
+
+        auto const first = seek(idx);
+        auto ptr = first;
+        for (uint i = 0; i < len; i++)
+            ptr += sequence_size(ptr, sentinel_);
+        return {first, int(ptr - first), int(len)};
+    }
+
+    // Fetch multi-utf8-scope to end of source.
+    scope document::
+    subspan(uint const idx) const noexcept {
+        if (idx >= uint(len_))
+            return {};
+
+        auto const first = seek(idx);
+        auto const last = seek(uint(len_));
+        return {first, int(last - first), len_ - int(idx)};
+    }
+
+    // Searches passed scope starting from code-point start_pos.
+    // Candidates are found with memchr on the first byte of the pattern.
+    std::optional<std::pair<uint, scope>> document::
+    search(scope const& sc, uint const start_pos) const noexcept {
+        if (sc.size_ == 0 || sc.len_ == 0)
+            return {};
+
+        auto ptr = seek(start_pos);
+        if (ptr == nullptr)
+            return {};
+
+        auto idx = start_pos;
+        while (sentinel_ - ptr >= sc.size_) {
+            auto const n = std::size_t(sentinel_ - ptr) - sc.size_ + 1;
+            auto const hit = static_cast<char const *>(std::memchr(ptr, *sc.addr_, n));
+            if (hit == nullptr)
+                break;
+
+            // Move to the candidate counting code-points on the way.
+            while (ptr < hit) {
+                ptr += sequence_size(ptr, sentinel_);
+                idx++;
+            }
+            if (ptr != hit)
+                continue;   // candidate was inside of a code-point
+
+            UTF8SPAN_COUNT(candidates, 1);
+            if (0 == std::memcmp(hit, sc.addr_, sc.size_)) {
+                // The match must end on a code-point boundary too.
+                auto const last = hit + sc.size_;
+                auto end = hit;
+                int len = 0;
+                for (; end < last; len++)
+                    end += sequence_size(end, sentinel_);
+                if (end == last)
+                    return std::make_pair(idx, scope(hit, sc.size_, len));
+            }
+            ptr += sequence_size(ptr, sentinel_);
+            idx++;
+        }
+        return {};
+    }
+}
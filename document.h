@@ -0,0 +1,69 @@
+#pragma once
+
+#include "scope.h"
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace ppx::utf8 {
+
+    /// Immutable utf8 text which may be shared between threads. \n
+    /// All operations are const (no cursor inside), iteration is done
+    /// with cursor objects (one per thread).
+    class document : public scope {
+        friend class cursor;
+        static constexpr uint IndexStride = 64;
+
+        char const *sentinel_{};    // address of char after last (end of source buffer)
+        std::string store_{};
+        std::vector<uint> index_{}; // byte offsets of every IndexStride-th code-point
+    public:
+        document() = delete;
+        ~document() override = default;
+        document(document const&) = delete;
+        document& operator=(document const&) = delete;
+        document(document&&) = delete;
+        document& operator=(document&&) = delete;
+
+        /// Document owns the data.
+        explicit document(std::string str, bool indexed = false);
+
+        /// Document does not own the data (owner must keep it alive).
+        document(char const *ptr, uint size, bool indexed = false);
+
+        /// Checks if document has code-point index.
+        [[nodiscard]] bool indexed() const noexcept {
+            return !index_.empty();
+        }
+
+        /// Fetch utf8-scope for code-point at index.
+        scope operator[](uint idx) const noexcept;
+
+        /// Returns whole document as scope.
+        scope operator()() const noexcept {
+            return {addr_, size_, len_};
+        }
+
+        /// Fetch multi-utf8-scope of a specific length.
+        /// \param idx - index of first code-point,
+        /// \param len - number of expected code-points.
+        /// \return scope for all code-points (if found).
+        [[nodiscard]] scope subspan(uint idx, uint len) const noexcept;
+
+        /// Fetch multi-utf8-scope to end of source.
+        /// \param idx - index of first code-point.
+        /// \return scope for all code-points (if found).
+        [[nodiscard]] scope subspan(uint idx) const noexcept;
+
+        /// Searches passed scope starting from code-point start_pos.
+        [[nodiscard]] std::optional<std::pair<uint, scope>>
+        search(scope const& sc, uint start_pos = 0) const noexcept;
+
+    private:
+        /// Counts code-points and builds index (if requested).
+        void build(bool indexed);
+
+        /// Returns address of code-point at index (nullptr if out of range).
+        [[nodiscard]] char const *seek(uint idx) const noexcept;
+    };
+}
@@ -0,0 +1,55 @@
+// Differential test of validation and decoding against the reference decoder.
+#include "fuzz.h"
+#include "reference.h"
+#include "../span.h"
+#include "../validator.h"
+
+using namespace ppx::utf8;
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *const data, std::size_t const size) {
+    std::string const text(reinterpret_cast<char const *>(data), size);
+    auto const units = reference::decode(text);
+
+    std::size_t first_invalid = text.size();
+    for (auto const& u: units)
+        if (!u.valid) {
+            first_invalid = u.offset;
+            break;
+        }
+    FUZZ_CHECK(validator::first_invalid(text.data(), text.size()) == first_invalid);
+
+    auto const replaced = reference::render(text, units, validator::Replacement);
+    auto const skipped = reference::render(text, units, {});
+    FUZZ_CHECK(validator::repair(text.data(), text.size(), validator::Replacement) == replaced);
+    FUZZ_CHECK(validator::repair(text.data(), text.size(), {}) == skipped);
+
+    // validating spans
+    span const strict{text, validation::strict};
+    FUZZ_CHECK(strict.size() == int(first_invalid));
+    FUZZ_CHECK(strict.error().has_value() == (first_invalid < text.size()));
+    span replace{text, validation::replace};
+    span skip{text, validation::skip};
+    FUZZ_CHECK(fuzz::view(scope(replace)) == replaced);
+    FUZZ_CHECK(fuzz::view(scope(skip)) == skipped);
+
+    // after replacement every code-point decodes as the reference says
+    std::size_t i = 0;
+    for (auto sc = replace.next(); sc.valid_chars(); sc = replace.next(), i++) {
+        FUZZ_CHECK(i < units.size());
+        auto const [ptr, n] = sc();
+        auto const cp = units[i].valid ? units[i].cp : 0xfffd;
+        FUZZ_CHECK(scope::decode(ptr, uint(n)) == cp);
+        if (units[i].valid)
+            FUZZ_CHECK(n == int(units[i].size));
+    }
+    FUZZ_CHECK(i == units.size());
+
+    // valid text: span units are exactly code-points
+    if (first_invalid == text.size()) {
+        auto const segments = reference::segments(text);
+        FUZZ_CHECK(segments.size() == units.size());
+        for (std::size_t k = 0; k < units.size(); k++)
+            FUZZ_CHECK(segments[k].size() == units[k].size);
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../scope.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fails the fuzz run (libFuzzer reports the crash and saves the input).
+#define FUZZ_CHECK(cond)                                                                    \
+    do {                                                                                    \
+        if (!(cond)) {                                                                      \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+            std::abort();                                                                   \
+        }                                                                                   \
+    } while (0)
+
+namespace ppx::utf8::fuzz {
+    inline std::string_view view(scope const& sc) {
+        auto const [ptr, size] = sc();
+        return {ptr, std::size_t(size)};
+    }
+
+    inline std::string join(std::vector<std::string_view> const& parts, std::size_t first, std::size_t n) {
+        std::string rv{};
+        for (auto i = first; i < first + n; i++)
+            rv += parts[i];
+        return rv;
+    }
+
+    /// Reads little-endian number from the front of the input (consumes the bytes).
+    inline uint take(uint8_t const *&data, std::size_t& size, std::size_t const n) {
+        uint rv = 0;
+        for (std::size_t i = 0; i < n && size > 0; i++, data++, size--)
+            rv |= uint(*data) << (8 * i);
+        return rv;
+    }
+}
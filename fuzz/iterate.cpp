@@ -0,0 +1,88 @@
+// Forward/backward iteration symmetry of span, document/cursor and rope.
+#include "fuzz.h"
+#include "reference.h"
+#include "../span.h"
+#include "../document.h"
+#include "../cursor.h"
+#include "../rope.h"
+#include <algorithm>
+
+using namespace ppx::utf8;
+
+namespace {
+    template<typename T>
+    std::vector<std::string_view> forward(T& it) {
+        std::vector<std::string_view> rv{};
+        it.begin();
+        for (auto sc = it.next(); sc.valid_chars(); sc = it.next()) {
+            FUZZ_CHECK(sc.len() == 1);
+            rv.push_back(fuzz::view(sc));
+        }
+        return rv;
+    }
+
+    template<typename T>
+    std::vector<std::string_view> backward(T& it) {
+        std::vector<std::string_view> rv{};
+        it.end();
+        for (auto sc = it.prev(); sc.valid_chars(); sc = it.prev()) {
+            FUZZ_CHECK(sc.len() == 1);
+            rv.push_back(fuzz::view(sc));
+        }
+        std::reverse(rv.begin(), rv.end());
+        return rv;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *const data, std::size_t const size) {
+    std::string const text(reinterpret_cast<char const *>(data), size);
+    auto const expected = reference::segments(text);
+
+    FUZZ_CHECK(scope::codepoints(text.data(), int(text.size())) == int(expected.size()));
+
+    span sp{text.data(), uint(text.size())};
+    FUZZ_CHECK(forward(sp) == expected);
+    FUZZ_CHECK(backward(sp) == expected);
+
+    document const doc{text.data(), uint(text.size()), true};
+    FUZZ_CHECK(doc.len() == int(expected.size()));
+    cursor cur{doc};
+    FUZZ_CHECK(forward(cur) == expected);
+    FUZZ_CHECK(backward(cur) == expected);
+
+    // Every step forward is undone by a step back.
+    cur.begin();
+    for (auto sc = cur.next(); sc.valid_chars(); sc = cur.next()) {
+        auto const idx = cur.index();
+        FUZZ_CHECK(fuzz::view(cur.prev()) == fuzz::view(sc));
+        FUZZ_CHECK(fuzz::view(cur.next()) == fuzz::view(sc));
+        FUZZ_CHECK(cur.index() == idx);
+    }
+
+    // Rope over copy of the text (compared by content).
+    rope rp{text};
+    auto const rope_forward = forward(rp);
+    auto const rope_backward = backward(rp);
+    FUZZ_CHECK(rope_forward.size() == expected.size());
+    FUZZ_CHECK(rope_backward.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        FUZZ_CHECK(rope_forward[i] == expected[i]);
+        FUZZ_CHECK(rope_backward[i] == expected[i]);
+    }
+
+    // Ropes built byte by byte (appending and prepending) see the same code-points.
+    rope appended{};
+    rope prepended{};
+    for (std::size_t i = 0; i < text.size(); i++) {
+        FUZZ_CHECK(appended.insert(uint(appended.len()), text.substr(i, 1)));
+        FUZZ_CHECK(prepended.insert(0, text.substr(text.size() - 1 - i, 1)));
+    }
+    for (auto* r: {&appended, &prepended}) {
+        FUZZ_CHECK(r->str() == text);
+        auto const got = forward(*r);
+        FUZZ_CHECK(got.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); i++)
+            FUZZ_CHECK(got[i] == expected[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Standalone driver for compilers without libFuzzer (gcc, msvc).
+// Runs the target on passed files (or files of passed directories),
+// without arguments on a fixed set of generated inputs.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, std::size_t size);
+
+namespace {
+    void run(std::string const& input) {
+        // copy - so ASan can see reads past the end
+        std::vector<uint8_t> const data(input.begin(), input.end());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+
+    void run(std::filesystem::path const& path) {
+        std::ifstream in(path, std::ios::binary);
+        run(std::string(std::istreambuf_iterator<char>(in), {}));
+    }
+
+    // Mix of valid code-points of every size and of the usual suspects:
+    // stray continuation bytes, truncated sequences, overlongs, surrogates, invalid bytes.
+    std::string generate(std::mt19937& rng) {
+        static std::string const pieces[] = {
+                "a", " ", "\t", "\n", ",", "\"", "A", "z",
+                "\xc3\xa4", "\xc3\x84", "\xc5\x81", "\xc3\x9f", "\xcc\x81",                 // ä Ä Ł ß combining acute
+                "\xe2\x82\xac", "\xe4\xb8\xad", "\xe1\xba\x9e", "\xef\xbc\xa1",             // € 中 ẞ Ａ
+                "\xf0\x9f\x98\x80", "\xf0\x90\x90\x80", "\xf4\x8f\xbf\xbf",                 // 😀 𐐀 U+10FFFF
+                "\x80", "\xbf", "\xc3", "\xe2\x82", "\xf0\x9f\x98",                         // stray, truncated
+                "\xc0\xaf", "\xe0\x80\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xff", "\xf8",
+        };
+        std::uniform_int_distribution<std::size_t> count(0, 24);
+        std::uniform_int_distribution<std::size_t> pick(0, std::size(pieces) - 1);
+        std::uniform_int_distribution<int> byte(0, 255);
+        std::uniform_int_distribution<int> coin(0, 7);
+
+        std::string rv{};
+        // leading bytes are often consumed as parameters by targets
+        rv += char(byte(rng));
+        rv += char(byte(rng));
+        for (auto n = count(rng); n > 0; n--)
+            rv += coin(rng) == 0 ? std::string(1, char(byte(rng))) : pieces[pick(rng)];
+        return rv;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        std::size_t n = 0;
+        for (int i = 1; i < argc; i++) {
+            std::filesystem::path const path{argv[i]};
+            if (std::filesystem::is_directory(path)) {
+                for (auto const& entry: std::filesystem::recursive_directory_iterator(path))
+                    if (entry.is_regular_file()) {
+                        run(entry.path());
+                        n++;
+                    }
+            } else {
+                run(path);
+                n++;
+            }
+        }
+        std::printf("%zu inputs passed\n", n);
+        return 0;
+    }
+
+    std::mt19937 rng{20240601};
+    constexpr int Runs = 20000;
+    for (int i = 0; i < Runs; i++)
+        run(generate(rng));
+    std::printf("%d generated inputs passed\n", Runs);
+    return 0;
+}
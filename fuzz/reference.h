@@ -0,0 +1,105 @@
+#pragma once
+#include "../scope.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reference decoders, written as plainly as possible (no tables, no fast paths),
+// to check the library against.
+namespace ppx::utf8::reference {
+    inline bool continuation(char const c) {
+        return (u8(c) & 0xc0) == 0x80;
+    }
+
+    /// Units as span iterates them: a byte which could start a sequence
+    /// (C2..DF, E0..EF, F0..F4) together with its continuation bytes if
+    /// all of them are present, otherwise every byte on its own.
+    inline std::vector<std::string_view> segments(std::string_view const s) {
+        std::vector<std::string_view> rv{};
+        for (std::size_t i = 0; i < s.size();) {
+            auto const b = u8(s[i]);
+            std::size_t n = 1;
+            if (b >= 0xc2 && b <= 0xdf) n = 2;
+            else if (b >= 0xe0 && b <= 0xef) n = 3;
+            else if (b >= 0xf0 && b <= 0xf4) n = 4;
+
+            std::size_t k = 1;
+            while (k < n && i + k < s.size() && continuation(s[i + k]))
+                k++;
+            if (k < n)
+                n = 1;
+            rv.push_back(s.substr(i, n));
+            i += n;
+        }
+        return rv;
+    }
+
+    struct unit {
+        std::size_t offset;
+        std::size_t size;
+        bool valid;
+        u32 cp;
+    };
+
+    /// Strict decoding (RFC 3629): valid code-points and invalid maximal subparts.
+    inline std::vector<unit> decode(std::string_view const s) {
+        std::vector<unit> rv{};
+        for (std::size_t i = 0; i < s.size();) {
+            auto const b = u8(s[i]);
+            if (b < 0x80) {
+                rv.push_back({i, 1, true, b});
+                i++;
+                continue;
+            }
+
+            int n;
+            u32 cp;
+            if ((b & 0xe0) == 0xc0) { n = 2; cp = b & 0x1f; }
+            else if ((b & 0xf0) == 0xe0) { n = 3; cp = b & 0x0f; }
+            else if ((b & 0xf8) == 0xf0) { n = 4; cp = b & 0x07; }
+            else {
+                rv.push_back({i, 1, false, 0});
+                i++;
+                continue;
+            }
+
+            // Can prefix (of have bytes) still become a valid code-point?
+            auto const possible = [n](u32 const prefix, int const have) {
+                auto const rest = 6 * (n - have);
+                auto lo = prefix << rest;
+                auto hi = lo | ((u32(1) << rest) - 1);
+                lo = std::max(lo, n == 2 ? 0x80u : n == 3 ? 0x800u : 0x10000u);
+                hi = std::min(hi, n == 2 ? 0x7ffu : n == 3 ? 0xffffu : 0x10ffffu);
+                if (lo > hi)
+                    return false;
+                return !(lo >= 0xd800 && hi <= 0xdfff);
+            };
+
+            int k = 1;
+            if (possible(cp, 1)) {
+                while (k < n && i + k < s.size() && continuation(s[i + k])) {
+                    auto const next = cp << 6 | (u8(s[i + k]) & 0x3f);
+                    if (!possible(next, k + 1))
+                        break;
+                    cp = next;
+                    k++;
+                }
+            }
+            if (k == n)
+                rv.push_back({i, std::size_t(n), true, cp});
+            else
+                rv.push_back({i, std::size_t(k), false, 0});
+            i += k;
+        }
+        return rv;
+    }
+
+    /// Decoded text with every invalid unit replaced by passed text.
+    inline std::string render(std::string_view const s, std::vector<unit> const& units, std::string_view const replacement) {
+        std::string rv{};
+        for (auto const& u: units)
+            rv += u.valid ? s.substr(u.offset, u.size) : replacement;
+        return rv;
+    }
+}
@@ -0,0 +1,53 @@
+// span::search and document::search against a naive search over code-points.
+#include "fuzz.h"
+#include "reference.h"
+#include "../span.h"
+#include "../document.h"
+
+using namespace ppx::utf8;
+
+namespace {
+    // The first code-point index >= start where pattern starts (and ends) on code-point boundaries.
+    std::optional<uint> naive(std::vector<std::string_view> const& text, std::vector<std::string_view> const& pattern,
+                              std::string const& bytes, uint const start) {
+        if (pattern.empty())
+            return {};
+        for (std::size_t i = start; i + pattern.size() <= text.size(); i++)
+            if (fuzz::join(text, i, pattern.size()) == bytes)
+                return uint(i);
+        return {};
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, std::size_t size) {
+    auto const pattern_size = fuzz::take(data, size, 1) % 8;
+    auto const start = fuzz::take(data, size, 1) % 16;
+    if (pattern_size > size)
+        return 0;
+    std::string const pattern(reinterpret_cast<char const *>(data), pattern_size);
+    std::string const text(reinterpret_cast<char const *>(data + pattern_size), size - pattern_size);
+
+    auto const text_segments = reference::segments(text);
+    auto const pattern_segments = reference::segments(pattern);
+    auto const sc = span{pattern}();
+
+    span sp{text.data(), uint(text.size())};
+    auto const expected = naive(text_segments, pattern_segments, pattern, 0);
+    auto const found = sp.search(sc);
+    FUZZ_CHECK(found.has_value() == expected.has_value());
+    if (found) {
+        FUZZ_CHECK(found->first == *expected);
+        FUZZ_CHECK(fuzz::view(found->second) == pattern);
+    }
+
+    document const doc{text.data(), uint(text.size())};
+    auto const expected_from = naive(text_segments, pattern_segments, pattern, start);
+    auto const doc_found = doc.search(sc, start);
+    FUZZ_CHECK(doc_found.has_value() == expected_from.has_value());
+    if (doc_found) {
+        FUZZ_CHECK(doc_found->first == *expected_from);
+        FUZZ_CHECK(fuzz::view(doc_found->second) == pattern);
+        FUZZ_CHECK(doc_found->second.len() == int(pattern_segments.size()));
+    }
+    return 0;
+}
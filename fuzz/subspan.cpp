@@ -0,0 +1,64 @@
+// Consistency of subspan, operator[] and skip with code-point indexes.
+#include "fuzz.h"
+#include "reference.h"
+#include "../span.h"
+#include "../document.h"
+#include "../cursor.h"
+#include "../rope.h"
+
+using namespace ppx::utf8;
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, std::size_t size) {
+    auto const idx = fuzz::take(data, size, 1);
+    auto const len = fuzz::take(data, size, 1);
+    std::string const text(reinterpret_cast<char const *>(data), size);
+    auto const expected = reference::segments(text);
+    auto const n = uint(expected.size());
+
+    span sp{text.data(), uint(text.size())};
+    document const doc{text.data(), uint(text.size()), idx % 2 == 0};
+    cursor cur{doc};
+    rope const rp{text};
+
+    // operator[]
+    auto const at = idx < n ? std::string(expected[idx]) : std::string{};
+    FUZZ_CHECK(fuzz::view(sp[idx]) == at);
+    FUZZ_CHECK(fuzz::view(doc[idx]) == at);
+    FUZZ_CHECK(fuzz::view(cur[idx]) == at);
+    FUZZ_CHECK(rp[idx].str() == at);
+
+    // subspan(idx, len)
+    auto const fits = len > 0 && idx < n && len <= n - idx;
+    auto const sub = fits ? fuzz::join(expected, idx, len) : std::string{};
+    auto const sp_sub = sp.subspan(idx, len);
+    auto const doc_sub = doc.subspan(idx, len);
+    FUZZ_CHECK(fuzz::view(sp_sub) == sub);
+    FUZZ_CHECK(fuzz::view(doc_sub) == sub);
+    FUZZ_CHECK(rp.subspan(idx, len).str() == sub);
+    if (fits) {
+        FUZZ_CHECK(sp_sub.len() == int(len));
+        FUZZ_CHECK(doc_sub.len() == int(len));
+        FUZZ_CHECK(rp.subspan(idx, len).len() == int(len));
+    }
+
+    // subspan(idx)
+    auto const tail = idx < n ? fuzz::join(expected, idx, n - idx) : std::string{};
+    FUZZ_CHECK(fuzz::view(sp.subspan(idx)) == tail);
+    FUZZ_CHECK(fuzz::view(doc.subspan(idx)) == tail);
+    FUZZ_CHECK(rp.subspan(idx).str() == tail);
+    if (idx < n)
+        FUZZ_CHECK(doc.subspan(idx).len() == int(n - idx));
+
+    // skip
+    cur.begin();
+    FUZZ_CHECK(cur.skip(idx) == (idx <= n));
+    if (idx < n)
+        FUZZ_CHECK(fuzz::view(cur.next()) == expected[idx]);
+    span fresh{text.data(), uint(text.size())};
+    if (n > 0) {
+        FUZZ_CHECK(fresh.skip(idx) == (idx <= n));
+        if (idx < n)
+            FUZZ_CHECK(fuzz::view(fresh.next()) == expected[idx]);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Round-trips through to_upper/to_lower, transliteration (whole, streamed and per code-point), width.
+#include "fuzz.h"
+#include "reference.h"
+#include "../span.h"
+#include "../transliterator.h"
+#include "../validator.h"
+
+using namespace ppx::utf8;
+
+namespace {
+    std::string str(std::vector<char> const& vec) {
+        return {vec.data(), vec.size()};
+    }
+
+    std::string upper(std::string const& s) {
+        return str(span{s}().to_upper());
+    }
+
+    std::string lower(std::string const& s) {
+        return str(span{s}().to_lower());
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, std::size_t size) {
+    auto const chunk = fuzz::take(data, size, 1) % 8 + 1;
+    std::string const raw(reinterpret_cast<char const *>(data), size);
+
+    // Case mapping of valid text.
+    auto const text = span{raw, validation::replace}().str();
+    auto const up = upper(text);
+    auto const low = lower(text);
+    FUZZ_CHECK(validator::first_invalid(up.data(), up.size()) == up.size());
+    FUZZ_CHECK(validator::first_invalid(low.data(), low.size()) == low.size());
+    FUZZ_CHECK(span{up}().len() == span{text}().len());
+    FUZZ_CHECK(span{low}().len() == span{text}().len());
+    FUZZ_CHECK(lower(up) == low);
+    FUZZ_CHECK(upper(low) == up);
+
+    // Transliteration of any bytes: whole scope and in chunks.
+    auto const whole = str(scope(raw.data(), int(raw.size())).transliterate());
+    FUZZ_CHECK(whole.size() <= raw.size());
+    transliterator tr{};
+    std::string streamed{};
+    std::vector<char> out(chunk + 3);
+    for (std::size_t i = 0; i < raw.size(); i += chunk) {
+        auto const n = std::min<std::size_t>(chunk, raw.size() - i);
+        streamed.append(out.data(), tr.feed(raw.data() + i, n, out.data()));
+    }
+    streamed.append(out.data(), tr.finish(out.data()));
+    FUZZ_CHECK(streamed == whole);
+
+    // ... and code-point by code-point (as span segments the text)
+    std::string reference{};
+    for (auto const seg: reference::segments(raw))
+        reference += str(scope(seg.data(), int(seg.size())).transliterate());
+    FUZZ_CHECK(whole == reference);
+
+    // Width (ASCII fast path against code-point by code-point sum) and truncation.
+    auto const segments = reference::segments(raw);
+    int width = 0;
+    for (auto const seg: segments)
+        width += scope::codepoint_width(scope::decode(seg.data(), uint(seg.size())));
+    scope const all(raw.data(), int(raw.size()));
+    FUZZ_CHECK(all.width() == width);
+
+    auto const columns = int(chunk * 2);
+    auto const cut = all.truncate(columns);
+    FUZZ_CHECK(cut.width() <= columns);
+    FUZZ_CHECK(cut.len() == scope::codepoints(raw.data(), cut.size()));
+    if (cut.size() < all.size()) {
+        auto const next = segments[cut.len()];
+        FUZZ_CHECK(scope(raw.data(), cut.size() + int(next.size())).width() > columns);
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include "fuzzy.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace ppx::utf8 {
+    namespace {
+        constexpr u32 CapitalSharpS = 0x1e9e;   // ẞ
+
+        constexpr bool has(folding const f, folding const flag) noexcept {
+            return (u8(f) & u8(flag)) != 0;
+        }
+
+        constexpr u32 ascii_lower(u32 const cp) noexcept {
+            return (cp >= 'A' && cp <= 'Z') ? cp + ('a' - 'A') : cp;
+        }
+
+        // Code-point of 2-byte sequence stored as u16 key of letter tables.
+        u32 decode_key(u16 const key) noexcept {
+            char const bytes[]{char(key & 0xff), char(key >> 8)};
+            return scope::decode(bytes, 2);
+        }
+    }
+
+    fuzzy::fuzzy(scope const& pattern, folding const f, bool const transpositions)
+            : folding_{f}, transpositions_{transpositions} {
+        auto [ptr, size] = pattern();
+        auto const sentinel = ptr + size;
+        while (ptr < sentinel) {
+            auto const n = scope::sequence_size(ptr, sentinel);
+            pattern_.push_back(fold(scope::decode(ptr, uint(n)), f));
+            ptr += n;
+        }
+
+        if (pattern_.size() > 64)
+            return;
+        for (std::size_t i = 0; i < pattern_.size(); i++) {
+            auto const cp = pattern_[i];
+            auto const bit = u64(1) << i;
+            if (cp < 128) {
+                ascii_[cp] |= bit;
+                continue;
+            }
+            auto it = std::find_if(other_.begin(), other_.end(), [cp](auto const& p) { return p.first == cp; });
+            if (it == other_.end())
+                other_.emplace_back(cp, bit);
+            else
+                it->second |= bit;
+        }
+    }
+
+    uint fuzzy::
+    distance(scope const& text) const {
+        if (pattern_.size() > 64)
+            return classic(text, 0, mode::global)->distance;
+        return myers(text, 0, mode::global)->distance;
+    }
+
+    std::optional<uint> fuzzy::
+    distance(scope const& text, uint const k) const {
+        // Length difference is a lower bound of the distance.
+        if (text.len() > 0 && uint(std::abs(text.len() - int(pattern_.size()))) > k)
+            return {};
+        auto const rv = pattern_.size() > 64 ? classic(text, k, mode::bounded) : myers(text, k, mode::bounded);
+        if (rv)
+            return rv->distance;
+        return {};
+    }
+
+    std::optional<fuzzy::hit> fuzzy::
+    search(scope const& text, uint const k) const {
+        if (pattern_.size() > 64)
+            return classic(text, k, mode::search);
+        return myers(text, k, mode::search);
+    }
+
+    // Code-point folded in passed mode.
+    u32 fuzzy::
+    fold(u32 const cp, folding const f) noexcept {
+        if (f == folding::none)
+            return cp;
+        if (cp < 0x80)
+            return has(f, folding::icase) ? ascii_lower(cp) : cp;
+        if (cp < 0x800)
+            return table(f)[cp];
+        if (cp == CapitalSharpS) {
+            if (has(f, folding::diacritics))
+                return has(f, folding::icase) ? 's' : 'S';
+            return has(f, folding::icase) ? 0xdf : cp;
+        }
+        return cp;
+    }
+
+    std::array<u32, 0x800> const& fuzzy::
+    table(folding const f) {
+        static auto const tables = [] {
+            std::array<std::array<u32, 0x800>, 4> rv{};
+            for (u8 mode = 0; mode < 4; mode++) {
+                auto& t = rv[mode];
+                for (u32 cp = 0; cp < t.size(); cp++)
+                    t[cp] = cp;
+                if (has(folding(mode), folding::icase))
+                    for (auto const& [upper, lower]: scope::Uppercase2)
+                        t[decode_key(upper)] = scope::decode(reinterpret_cast<char const *>(lower.data()), 2);
+                // letter without diacritics - first letter of its transliteration (ä -> ae -> a)
+                if (has(folding(mode), folding::diacritics))
+                    for (auto const& [key, ascii]: scope::Transliteration2) {
+                        auto const base = u32(u8(ascii[0]));
+                        t[decode_key(key)] = has(folding(mode), folding::icase) ? ascii_lower(base) : base;
+                    }
+            }
+            return rv;
+        }();
+        return tables[u8(f) & 3];
+    }
+
+    // Bit mask of pattern positions with passed code-point.
+    fuzzy::u64 fuzzy::
+    mask(u32 const cp) const noexcept {
+        if (cp < 128)
+            return ascii_[cp];
+        for (auto const& [c, m]: other_)
+            if (c == cp)
+                return m;
+        return 0;
+    }
+
+    // Bit-parallel algorithm (Hyyrö, with transpositions if requested).
+    std::optional<fuzzy::hit> fuzzy::
+    myers(scope const& text, uint const k, mode const md) const noexcept {
+        auto [ptr, size] = text();
+        auto const sentinel = ptr + size;
+        auto const m = uint(pattern_.size());
+
+        if (m == 0) {
+            if (md == mode::search)
+                return hit{0, 0};
+            auto const n = uint(scope::codepoints(ptr, size));
+            if (md == mode::bounded && n > k)
+                return {};
+            return hit{n, n};
+        }
+        if (md == mode::search && m <= k)
+            return hit{0, m};
+
+        auto const last = u64(1) << (m - 1);
+        u64 vp = ~u64(0);
+        u64 vn = 0;
+        u64 d0 = 0;
+        u64 prev = 0;
+        uint score = m;
+        uint j = 0;
+        while (ptr < sentinel) {
+            u32 cp;
+            if (auto const c = static_cast<u8>(*ptr); c < 0x80) {
+                cp = has(folding_, folding::icase) ? ascii_lower(c) : c;
+                ptr += 1;
+            } else {
+                auto const n = uint(scope::sequence_size(ptr, sentinel));
+                cp = fold(scope::decode(ptr, n), folding_);
+                ptr += n;
+            }
+
+            auto const pm = mask(cp);
+            auto const tr = transpositions_ ? (((~d0) & pm) << 1) & prev : 0;
+            d0 = (((pm & vp) + vp) ^ vp) | pm | vn | tr;
+            auto const hp = vn | ~(d0 | vp);
+            auto const hn = d0 & vp;
+            if (hp & last)
+                score++;
+            else if (hn & last)
+                score--;
+            auto const x = md == mode::search ? hp << 1 : (hp << 1) | 1;
+            vn = x & d0;
+            vp = (hn << 1) | ~(x | d0);
+            prev = pm;
+            j++;
+
+            if (md == mode::search && score <= k)
+                return hit{j, score};
+            // Every remaining code-point (at least one byte) may lower the score by one.
+            if (md == mode::bounded && i64(score) > i64(k) + (sentinel - ptr))
+                return {};
+        }
+
+        if (md == mode::search || (md == mode::bounded && score > k))
+            return {};
+        return hit{j, score};
+    }
+
+    // Classic dynamic programming (for patterns longer than 64 code-points).
+    std::optional<fuzzy::hit> fuzzy::
+    classic(scope const& text, uint const k, mode const md) const {
+        auto const m = pattern_.size();
+        std::vector<uint> before(m + 1), prev(m + 1), cur(m + 1);
+        for (std::size_t i = 0; i <= m; i++)
+            prev[i] = uint(i);
+
+        auto [ptr, size] = text();
+        auto const sentinel = ptr + size;
+        u32 last_cp = 0;
+        uint j = 0;
+        while (ptr < sentinel) {
+            auto const n = uint(scope::sequence_size(ptr, sentinel));
+            auto const cp = fold(scope::decode(ptr, n), folding_);
+            ptr += n;
+            j++;
+
+            cur[0] = md == mode::search ? 0 : j;
+            for (std::size_t i = 1; i <= m; i++) {
+                cur[i] = std::min({prev[i] + 1, cur[i - 1] + 1, prev[i - 1] + (pattern_[i - 1] != cp)});
+                if (transpositions_ && i > 1 && j > 1 && pattern_[i - 1] == last_cp && pattern_[i - 2] == cp)
+                    cur[i] = std::min(cur[i], before[i - 2] + 1);
+            }
+            if (md == mode::search && cur[m] <= k)
+                return hit{j, cur[m]};
+            if (md == mode::bounded && *std::min_element(cur.begin(), cur.end()) > k)
+                return {};
+
+            std::swap(before, prev);
+            std::swap(prev, cur);
+            last_cp = cp;
+        }
+
+        if (md == mode::search || (md == mode::bounded && prev[m] > k))
+            return {};
+        return hit{j, prev[m]};
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "scope.h"
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ppx::utf8 {
+
+    /// How code-points are compared by fuzzy.
+    enum class folding : u8 {
+        none = 0,
+        icase = 1,          // Ł == ł (ASCII, polish and german letters)
+        diacritics = 2,     // ł == l, ä == a, ß == s
+        both = 3,
+    };
+
+    /// Edit distance on code-points (bit-parallel Myers/Hyyrö algorithm). \n
+    /// The pattern is prepared once, so one fuzzy can screen many candidates.
+    /// Patterns longer than 64 code-points fall back to the classic O(nm) algorithm
+    /// (which allocates, so distance and search may throw std::bad_alloc).
+    class fuzzy {
+        using u64 = uint64_t;
+
+        std::vector<u32> pattern_{};    // folded code-points
+        std::array<u64, 128> ascii_{};  // pattern bit masks of ASCII code-points
+        std::vector<std::pair<u32, u64>> other_{};  // ... and of the rest
+        folding folding_;
+        bool transpositions_;
+    public:
+        /// Result of search.
+        struct hit {
+            uint end;           // index of code-point after the match
+            uint distance;
+        };
+
+        fuzzy() = delete;
+        ~fuzzy() = default;
+        fuzzy(fuzzy const&) = default;
+        fuzzy& operator=(fuzzy const&) = default;
+        fuzzy(fuzzy&&) = default;
+        fuzzy& operator=(fuzzy&&) = default;
+
+        /// \param pattern - searched text,
+        /// \param f - code-point folding,
+        /// \param transpositions - when true swap of two adjacent code-points
+        ///        costs 1 (Damerau, optimal string alignment), otherwise 2 (Levenshtein).
+        explicit fuzzy(scope const& pattern, folding f = folding::none, bool transpositions = false);
+
+        /// Returns number of code-points in pattern.
+        [[nodiscard]] uint len() const noexcept {
+            return uint(pattern_.size());
+        }
+
+        /// Computes edit distance between pattern and text.
+        [[nodiscard]] uint distance(scope const& text) const;
+
+        /// Computes edit distance if it is not greater than k
+        /// (gives up as soon as it is known to be greater).
+        [[nodiscard]] std::optional<uint> distance(scope const& text, uint k) const;
+
+        /// Searches the first place where text contains pattern with at most k errors.
+        [[nodiscard]] std::optional<hit> search(scope const& text, uint k) const;
+
+        /// Returns code-point folded in passed mode.
+        static u32 fold(u32 cp, folding f) noexcept;
+
+    private:
+        enum class mode { global, bounded, search };
+
+        /// Folding of code-points below U+0800 (built once from letter tables).
+        static std::array<u32, 0x800> const& table(folding f);
+
+        [[nodiscard]] u64 mask(u32 cp) const noexcept;
+        [[nodiscard]] std::optional<hit> myers(scope const& text, uint k, mode m) const noexcept;
+        [[nodiscard]] std::optional<hit> classic(scope const& text, uint k, mode m) const;
+    };
+}
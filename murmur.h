@@ -11,12 +11,53 @@ namespace ppx {
     public:
         static u32 hash3(void const *, u32, u32);
 
+        /// Compile-time capable version (reads the key byte by byte).
+        static constexpr u32 hash3(char const *const key, u32 const len, u32 const seed) noexcept {
+            auto const nblocks = len / 4;
+            u32 h1 = seed;
+
+            u32 const c1 = 0xcc9e2d51;
+            u32 const c2 = 0x1b873593;
+
+            for (u32 i = 0; i < nblocks; i++) {
+                u32 k1 = load32(key + 4 * i);
+                k1 *= c1;
+                k1 = rotl32(k1, 15);
+                k1 *= c2;
+
+                h1 ^= k1;
+                h1 = rotl32(h1, 13);
+                h1 = h1 * 5 + 0xe6546b64;
+            }
+
+            auto const tail = key + nblocks * 4;
+            u32 k1 = 0;
+            switch (len & 3) {
+                case 3:
+                    k1 ^= u32(u8(tail[2])) << 16;
+                    [[fallthrough]];
+                case 2:
+                    k1 ^= u32(u8(tail[1])) << 8;
+                    [[fallthrough]];
+                case 1:
+                    k1 ^= u32(u8(tail[0]));
+                    k1 *= c1;
+                    k1 = rotl32(k1, 15);
+                    k1 *= c2;
+                    h1 ^= k1;
+            }
+
+            h1 ^= len;
+            h1 = fmix32(h1);
+            return h1;
+        }
+
     private:
-        static u32 rotl32(u32 const x, i8 const r) {
+        static constexpr u32 rotl32(u32 const x, i8 const r) {
             return (x << r) | (x >> (32 - r));
         }
 
-        static u32 fmix32(u32 h) {
+        static constexpr u32 fmix32(u32 h) {
             h ^= h >> 16;
             h *= 0x85ebca6b;
             h ^= h >> 13;
@@ -24,5 +65,13 @@ namespace ppx {
             h ^= h >> 16;
             return h;
         }
+
+        /// Little-endian 32-bit block (compilers fold it to a single load).
+        static constexpr u32 load32(char const *const ptr) {
+            return u32(u8(ptr[0]))
+                   | u32(u8(ptr[1])) << 8
+                   | u32(u8(ptr[2])) << 16
+                   | u32(u8(ptr[3])) << 24;
+        }
     };
 }
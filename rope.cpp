@@ -0,0 +1,419 @@
+#include "rope.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace ppx::utf8 {
+    struct rope::node {
+        scope piece;
+        owner_ptr owner;        // keeps piece data alive (nullptr if not owned)
+        node_ptr left;
+        node_ptr right;
+        uint priority;
+        uint len;               // code-points in subtree
+        uint size;              // bytes in subtree
+        uint count;             // pieces in subtree
+    };
+
+    rope::rope(std::string_view const str) {
+        if (str.empty())
+            return;
+        std::shared_ptr<char[]> owner(new char[str.size()]);
+        std::memcpy(owner.get(), str.data(), str.size());
+        root_ = build(owner.get(), uint(str.size()), owner);
+        begin();
+    }
+
+    rope::rope(char const *const ptr, uint const size)
+            : root_{build(ptr, size, nullptr)} {
+        begin();
+    }
+
+    rope::rope(node_ptr root) noexcept
+            : root_{std::move(root)} {
+        begin();
+    }
+
+    // The cursor points into nodes owned by root_, so it moves together with them
+    // and the source is left empty with rewound cursor.
+    rope::rope(rope&& other) noexcept
+            : root_{std::move(other.root_)}, piece_{other.piece_}, piece_no_{other.piece_no_},
+              ptr_{other.ptr_}, idx_{other.idx_} {
+        other.reset();
+    }
+
+    rope& rope::
+    operator=(rope&& other) noexcept {
+        if (this != &other) {
+            root_ = std::move(other.root_);
+            piece_ = other.piece_;
+            piece_no_ = other.piece_no_;
+            ptr_ = other.ptr_;
+            idx_ = other.idx_;
+            other.reset();
+        }
+        return *this;
+    }
+
+    // Empty rope with cursor at the beginning.
+    void rope::
+    reset() noexcept {
+        root_ = nullptr;
+        piece_ = nullptr;
+        ptr_ = nullptr;
+        idx_ = piece_no_ = 0;
+    }
+
+    int rope::
+    size() const noexcept {
+        return root_ ? int(root_->size) : 0;
+    }
+
+    int rope::
+    len() const noexcept {
+        return root_ ? int(root_->len) : 0;
+    }
+
+    std::string rope::
+    str() const {
+        std::string rv;
+        rv.reserve(size());
+        // in-order traversal without recursion (depth is O(log n) anyway)
+        std::vector<node const *> stack;
+        for (auto n = root_.get(); n || !stack.empty();) {
+            if (n) {
+                stack.push_back(n);
+                n = n->left.get();
+                continue;
+            }
+            n = stack.back();
+            stack.pop_back();
+            auto const [first, size] = n->piece();
+            rv.append(first, size);
+            n = n->right.get();
+        }
+        return rv;
+    }
+
+    // Fetch utf8-scope for code-point at index.
+    scope rope::
+    operator[](uint idx) const noexcept {
+        for (auto n = root_.get(); n;) {
+            auto const left = n->left ? n->left->len : 0;
+            if (idx < left) {
+                n = n->left.get();
+                continue;
+            }
+            idx -= left;
+            if (idx < uint(n->piece.len_)) {
+                auto ptr = n->piece.addr_;
+                auto const sentinel = ptr + n->piece.size_;
+                for (uint i = 0; i < idx; i++)
+                    ptr += scope::sequence_size(ptr, sentinel);
+                return scope::forward(ptr, sentinel);
+            }
+            idx -= n->piece.len_;
+            n = n->right.get();
+        }
+        return {};
+    }
+
+    // Fetch rope of a specific length.
+    rope rope::
+    subspan(uint const idx, uint const len) const {
+        if (len == 0 || idx >= uint(this->len()) || len > uint(this->len()) - idx)
+            return {};
+        auto const [_, tail] = split(root_, idx);
+        return rope(split(tail, len).first);
+    }
+
+    // Fetch rope to end of text.
+    rope rope::
+    subspan(uint const idx) const {
+        if (idx >= uint(len()))
+            return {};
+        return rope(split(root_, idx).second);
+    }
+
+    bool rope::
+    insert(uint const idx, std::string_view const text) {
+        if (idx > uint(len()))
+            return false;
+        if (!text.empty()) {
+            auto const [head, tail] = split(root_, idx);
+            root_ = join(head, text, tail);
+        }
+        begin();
+        return true;
+    }
+
+    bool rope::
+    erase(uint const idx, uint const len) {
+        if (idx > uint(this->len()) || len > uint(this->len()) - idx)
+            return false;
+        if (len > 0) {
+            auto const [head, rest] = split(root_, idx);
+            root_ = join(head, {}, split(rest, len).second);
+        }
+        begin();
+        return true;
+    }
+
+    // Rewind cursor to beginning of text.
+    void rope::
+    begin() noexcept {
+        UTF8SPAN_COUNT(rewinds, 1);
+        piece_no_ = 0;
+        piece_ = leaf(root_.get(), 0);
+        ptr_ = piece_ ? piece_->piece.addr_ : nullptr;
+        idx_ = 0;
+    }
+
+    // Rewind cursor to after end of text.
+    void rope::
+    end() noexcept {
+        if (!root_) {
+            begin();
+            return;
+        }
+        piece_no_ = root_->count - 1;
+        piece_ = leaf(root_.get(), piece_no_);
+        ptr_ = piece_->piece.addr_ + piece_->piece.size_;
+        idx_ = root_->len;
+    }
+
+    // Get scope for current utf8.
+    scope rope::
+    next() noexcept {
+        if (root_ == nullptr)
+            return {};
+        if (ptr_ == piece_->piece.addr_ + piece_->piece.size_) {
+            if (piece_no_ + 1 >= root_->count)
+                return {};
+            piece_ = leaf(root_.get(), ++piece_no_);
+            ptr_ = piece_->piece.addr_;
+        }
+        auto rv = scope::forward(ptr_, piece_->piece.addr_ + piece_->piece.size_);
+        if (rv.valid_chars()) {
+            UTF8SPAN_COUNT(steps, 1);
+            idx_ += 1;
+        }
+        return rv;
+    }
+
+    // Get scope for previous utf8.
+    scope rope::
+    prev() noexcept {
+        if (root_ == nullptr)
+            return {};
+        if (ptr_ == piece_->piece.addr_) {
+            if (piece_no_ == 0)
+                return {};
+            piece_ = leaf(root_.get(), --piece_no_);
+            ptr_ = piece_->piece.addr_ + piece_->piece.size_;
+        }
+        auto rv = scope::backward(ptr_, piece_->piece.addr_);
+        if (rv.valid_chars()) {
+            UTF8SPAN_COUNT(steps, 1);
+            idx_ -= 1;
+        }
+        return rv;
+    }
+
+    // Random priority of the treap node (xorshift).
+    uint rope::
+    priority() noexcept {
+        thread_local u32 state = 0x9e3779b9;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    rope::node_ptr rope::
+    make(scope piece, owner_ptr owner, node_ptr left, node_ptr right, uint const priority) {
+        auto const len = uint(piece.len_) + (left ? left->len : 0) + (right ? right->len : 0);
+        auto const size = uint(piece.size_) + (left ? left->size : 0) + (right ? right->size : 0);
+        auto const count = 1 + (left ? left->count : 0) + (right ? right->count : 0);
+        return std::make_shared<node const>(node{
+                piece, std::move(owner), std::move(left), std::move(right), priority, len, size, count});
+    }
+
+    // Copy of node with new children.
+    rope::node_ptr rope::
+    with(node const& n, node_ptr left, node_ptr right) {
+        return make(n.piece, n.owner, std::move(left), std::move(right), n.priority);
+    }
+
+    // Builds treap of pieces (at most MaxPiece bytes, whole code-points).
+    rope::node_ptr rope::
+    build(char const *ptr, uint const size, owner_ptr const& owner) {
+        node_ptr root{};
+        auto const sentinel = ptr + size;
+        while (ptr < sentinel) {
+            auto const first = ptr;
+            int len = 0;
+            while (ptr < sentinel) {
+                auto const n = scope::sequence_size(ptr, sentinel);
+                if (ptr - first + n > MaxPiece && len > 0)
+                    break;
+                ptr += n;
+                len += 1;
+            }
+            root = merge(root, make({first, int(ptr - first), len}, owner, nullptr, nullptr, priority()));
+        }
+        return root;
+    }
+
+    rope::node_ptr rope::
+    merge(node_ptr const& a, node_ptr const& b) {
+        if (!a) return b;
+        if (!b) return a;
+        if (a->priority > b->priority)
+            return with(*a, a->left, merge(a->right, b));
+        return with(*b, merge(a, b->left), b->right);
+    }
+
+    // Joins head, text and tail. Small pieces around the seams are copied together
+    // with the text into one piece, so that small edits do not fragment the rope.
+    rope::node_ptr rope::
+    join(node_ptr head, std::string_view const text, node_ptr tail) {
+        node const *last = head ? leaf(head.get(), head->count - 1) : nullptr;
+        node const *first = tail ? leaf(tail.get(), 0) : nullptr;
+        uint size = uint(text.size());
+        if (last && uint(last->piece.size_) + size <= MaxPiece)
+            size += uint(last->piece.size_);
+        else
+            last = nullptr;
+        if (first && uint(first->piece.size_) + size <= MaxPiece)
+            size += uint(first->piece.size_);
+        else
+            first = nullptr;
+        if (size == 0)
+            return concat(head, tail);
+
+        std::shared_ptr<char[]> owner(new char[size]);
+        auto out = owner.get();
+        if (last) {
+            std::memcpy(out, last->piece.addr_, last->piece.size_);
+            out += last->piece.size_;
+        }
+        if (!text.empty())
+            std::memcpy(out, text.data(), text.size());
+        out += text.size();
+        if (first)
+            std::memcpy(out, first->piece.addr_, first->piece.size_);
+        auto const middle = build(owner.get(), size, owner);
+
+        if (last)
+            head = split(head, head->len - last->piece.len_).first;
+        if (first)
+            tail = split(tail, first->piece.len_).second;
+        return concat(concat(head, middle), tail);
+    }
+
+    // Merges a and b. Pieces are segmented separately, so a code-point which
+    // starts in a and continues in b (malformed bytes glued by an edit)
+    // is fused into one piece - code-points of rope are always those of its text.
+    rope::node_ptr rope::
+    concat(node_ptr a, node_ptr b) {
+        while (a && b && glued(*a, *b)) {
+            // the last piece of a and at least 3 bytes of b (the longest rest of a code-point)
+            auto const last = leaf(a.get(), a->count - 1);
+            std::string bytes(last->piece.addr_, last->piece.size_);
+            auto const a_len = a->len - uint(last->piece.len_);
+            uint b_len = 0;
+            for (uint no = 0; no < b->count && bytes.size() < uint(last->piece.size_) + 3; no++) {
+                auto const& piece = leaf(b.get(), no)->piece;
+                bytes.append(piece.addr_, piece.size_);
+                b_len += uint(piece.len_);
+            }
+
+            std::shared_ptr<char[]> owner(new char[bytes.size()]);
+            std::memcpy(owner.get(), bytes.data(), bytes.size());
+            a = split(a, a_len).first;
+            b = merge(build(owner.get(), uint(bytes.size()), owner), split(b, b_len).second);
+        }
+        return merge(a, b);
+    }
+
+    // Checks if the last code-point of a continues in b.
+    bool rope::
+    glued(node const& a, node const& b) noexcept {
+        // at most 3 bytes before the seam and 3 after it
+        char window[6];
+        int before = 0;
+        for (auto no = a.count; no-- > 0 && before < 3;) {
+            auto const& piece = leaf(&a, no)->piece;
+            auto const n = std::min(3 - before, piece.size_);
+            std::memmove(window + n, window, before);
+            std::memcpy(window, piece.addr_ + piece.size_ - n, n);
+            before += n;
+        }
+        auto size = before;
+        for (uint no = 0; no < b.count && size < before + 3; no++) {
+            auto const& piece = leaf(&b, no)->piece;
+            auto const n = std::min(before + 3 - size, piece.size_);
+            std::memcpy(window + size, piece.addr_, n);
+            size += n;
+        }
+
+        // the last byte before the seam which starts a code-point
+        auto lead = before - 1;
+        while (lead >= 0 && scope::is_continuation(window[lead]))
+            lead--;
+        return lead >= 0 && int(scope::sequence_size(window + lead, window + size)) > before - lead;
+    }
+
+    // Splits treap after idx code-points.
+    std::pair<rope::node_ptr, rope::node_ptr> rope::
+    split(node_ptr const& t, uint const idx) {
+        if (!t)
+            return {};
+
+        auto const left = t->left ? t->left->len : 0;
+        if (idx <= left) {
+            auto [a, b] = split(t->left, idx);
+            return {std::move(a), with(*t, std::move(b), t->right)};
+        }
+
+        auto const rest = idx - left;
+        auto const len = uint(t->piece.len_);
+        if (rest >= len) {
+            auto [a, b] = split(t->right, rest - len);
+            return {with(*t, t->left, std::move(a)), std::move(b)};
+        }
+
+        // The piece itself must be cut.
+        auto ptr = t->piece.addr_;
+        auto const sentinel = ptr + t->piece.size_;
+        for (uint i = 0; i < rest; i++)
+            ptr += scope::sequence_size(ptr, sentinel);
+        auto const head_size = int(ptr - t->piece.addr_);
+        scope const head{t->piece.addr_, head_size, int(rest)};
+        scope const tail{ptr, t->piece.size_ - head_size, int(len - rest)};
+        // Both parts inherit priority of t (not lower than any node below it),
+        // so the results fit under t's ancestors without breaking the heap order.
+        return {
+                merge(t->left, make(head, t->owner, nullptr, nullptr, t->priority)),
+                merge(make(tail, t->owner, nullptr, nullptr, t->priority), t->right)
+        };
+    }
+
+    // Leaf number no (in order).
+    rope::node const *rope::
+    leaf(node const *t, uint no) noexcept {
+        while (t) {
+            auto const left = t->left ? t->left->count : 0;
+            if (no < left) {
+                t = t->left.get();
+                continue;
+            }
+            if (no == left)
+                return t;
+            no -= left + 1;
+            t = t->right.get();
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "scope.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace ppx::utf8 {
+
+    /// Editable utf8 text (persistent treap of pieces). \n
+    /// Every node holds a piece - scope of at most MaxPiece bytes - and caches number of
+    /// code-points, bytes and pieces of its subtree, so operator[], subspan,
+    /// insert and erase by code-point index take O(log n). \n
+    /// Copies and subspans share nodes (copying is O(1)). \n
+    /// Edits copy small pieces around the edit into one piece (at most MaxPiece bytes),
+    /// so that the number of pieces stays proportional to the size of text. \n
+    /// Code-points are those of the text, whatever the history of edits was
+    /// (rope and span over the same bytes agree).
+    /// Inserted text is owned by rope; text passed by pointer is not
+    /// (the owner must ensure that the data lives longer than rope).
+    class rope {
+        static constexpr uint MaxPiece = 512;
+
+        struct node;
+        using node_ptr = std::shared_ptr<node const>;
+        using owner_ptr = std::shared_ptr<char const[]>;
+
+        node_ptr root_{};
+        // cursor
+        node const *piece_{};   // leaf under cursor
+        uint piece_no_{};       // number of that leaf (in order)
+        char const *ptr_{};     // position in the leaf
+        uint idx_{};            // code-point index
+    public:
+        rope() = default;
+        ~rope() = default;
+        rope(rope const&) = default;
+        rope& operator=(rope const&) = default;
+        rope(rope&& other) noexcept;
+        rope& operator=(rope&& other) noexcept;
+
+        /// Rope owns a copy of the string.
+        explicit rope(std::string_view str);
+
+        /// Rope does not own the data.
+        rope(char const *ptr, uint size);
+
+        /// Returns number of bytes.
+        [[nodiscard]] int size() const noexcept;
+
+        /// Returns number of code-points.
+        [[nodiscard]] int len() const noexcept;
+
+        /// Checks if contains any byte.
+        [[nodiscard]] bool empty() const noexcept {
+            return root_ == nullptr;
+        }
+
+        /// Converts to std::string.
+        [[nodiscard]] std::string str() const;
+
+        /// Fetch utf8-scope for code-point at index.
+        scope operator[](uint idx) const noexcept;
+
+        /// Fetch rope of a specific length (shares nodes with this rope).
+        /// \param idx - index of first code-point,
+        /// \param len - number of expected code-points.
+        /// \return rope for all code-points (empty if not found).
+        [[nodiscard]] rope subspan(uint idx, uint len) const;
+
+        /// Fetch rope to end of text.
+        [[nodiscard]] rope subspan(uint idx) const;
+
+        /// Inserts copy of text before code-point at index (idx == len() appends).
+        /// The cursor is rewound to the beginning.
+        bool insert(uint idx, std::string_view text);
+
+        /// Removes len code-points starting from index.
+        /// The cursor is rewound to the beginning.
+        bool erase(uint idx, uint len);
+
+        /// Rewind cursor to beginning of text.
+        void begin() noexcept;
+
+        /// Rewind cursor to after end of text.
+        void end() noexcept;
+
+        /// Get scope for current utf8.
+        /// After success cursor is moved forward (to the next utf8).
+        scope next() noexcept;
+
+        /// Get scope for previous utf8.
+        /// After success cursor in moved to the utf8's position.
+        scope prev() noexcept;
+
+    private:
+        explicit rope(node_ptr root) noexcept;
+
+        void reset() noexcept;
+
+        static uint priority() noexcept;
+        static node_ptr make(scope piece, owner_ptr owner, node_ptr left, node_ptr right, uint priority);
+        static node_ptr with(node const& n, node_ptr left, node_ptr right);
+        static node_ptr build(char const *ptr, uint size, owner_ptr const& owner);
+        static node_ptr merge(node_ptr const& a, node_ptr const& b);
+        static node_ptr join(node_ptr head, std::string_view text, node_ptr tail);
+        static node_ptr concat(node_ptr a, node_ptr b);
+        static bool glued(node const& a, node const& b) noexcept;
+        static std::pair<node_ptr, node_ptr> split(node_ptr const& t, uint idx);
+        static node const *leaf(node const *t, uint no) noexcept;
+    };
+}
@@ -1,4 +1,8 @@
 #include "scope.h"
+#include "ascii.h"
+#include "width_table.h"
+#include <algorithm>
+#include <cstring>
 
 namespace ppx::utf8 {
     // https://design215.com/toolbox/ascii-utf8.php
@@ -39,17 +43,39 @@ namespace ppx::utf8 {
             {0xbcc3, {0xc3, 0x9c}},      // ü -> Ü
             {0x9fc3, {0xe1, 0xba, 0x9e}},// ß -> ẞ
     };
+    const std::unordered_map<u16, std::string_view> scope::Transliteration2{
+            // polish
+            {0x84c4, "A"},  {0x85c4, "a"},      // Ą ą
+            {0x86c4, "C"},  {0x87c4, "c"},      // Ć ć
+            {0x98c4, "E"},  {0x99c4, "e"},      // Ę ę
+            {0x81c5, "L"},  {0x82c5, "l"},      // Ł ł
+            {0x83c5, "N"},  {0x84c5, "n"},      // Ń ń
+            {0x93c3, "O"},  {0xb3c3, "o"},      // Ó ó
+            {0x9ac5, "S"},  {0x9bc5, "s"},      // Ś ś
+            {0xb9c5, "Z"},  {0xbac5, "z"},      // Ź ź
+            {0xbbc5, "Z"},  {0xbcc5, "z"},      // Ż ż
+            // german
+            {0x84c3, "Ae"}, {0xa4c3, "ae"},     // Ä ä
+            {0x96c3, "Oe"}, {0xb6c3, "oe"},     // Ö ö
+            {0x9cc3, "Ue"}, {0xbcc3, "ue"},     // Ü ü
+            {0x9fc3, "ss"},                     // ß
+    };
+    const std::unordered_map<u32, std::string_view> scope::Transliteration3{
+            // german
+            {0x9ebae1, "SS"}                    // ẞ
+    };
 
-    // operator+=
-    scope& scope::operator+=(scope const& rhs) noexcept {
-        // The beginning of rhs must be the end of me.
-        // The added scopes must create continuity.
-        if ((addr_ + size_) == rhs.addr_) {
-            size_ += rhs.size_;
-            if (len_ != -1 && rhs.len_ != -1)
-                len_ += rhs.len_;
+    namespace {
+        // Shrinks result of a transform to its size. Counts the reallocations
+        // past the initial reserve (output grows at most 1.5x, so at most once).
+        void shrink(std::vector<char>& vec, std::size_t const reserved) {
+            if (vec.capacity() != reserved)
+                UTF8SPAN_COUNT(allocated, vec.capacity());
+            auto const capacity = vec.capacity();
+            vec.shrink_to_fit();
+            if (vec.capacity() != capacity)
+                UTF8SPAN_COUNT(allocated, vec.capacity());
         }
-        return *this;
     }
 
     // to_upper
@@ -57,16 +83,18 @@ namespace ppx::utf8 {
     to_upper() const noexcept {
         std::vector<char> vec;
         vec.reserve(size_);
+        auto const reserved = vec.capacity();
+        UTF8SPAN_COUNT(allocated, reserved);
 
         auto ptr = addr_;
         auto const sentinel = addr_ + size_;
         for (int cp_counter = 0; cp_counter < len_ && ptr < sentinel; cp_counter++) {
-            switch (codepoint_size(ptr)) {
+            switch (sequence_size(ptr, sentinel)) {
                 case 1:
-                    vec.push_back(char(std::toupper(*ptr++)));
+                    vec.push_back(char(std::toupper(u8(*ptr++))));
                     break;
                 case 2: {
-                    auto const w = *(u16 *) ptr;
+                    auto const w = u16(u8(ptr[0]) | u8(ptr[1]) << 8);
                     if (auto it = SmallLetters.find(w); it != SmallLetters.end()) {
                         for (auto const c: it->second)
                             vec.push_back(char(c));
@@ -82,25 +110,31 @@ namespace ppx::utf8 {
                     vec.push_back(*ptr++);
                     vec.push_back(*ptr++);
                     break;
+                case 4:
+                    vec.insert(vec.end(), ptr, ptr + 4);
+                    ptr += 4;
+                    break;
             }
         }
-        vec.shrink_to_fit();
+        shrink(vec, reserved);
         return vec;
     }
     [[nodiscard]] std::vector<char> scope::
     to_lower() const noexcept {
         std::vector<char> vec;
         vec.reserve(size_);
+        auto const reserved = vec.capacity();
+        UTF8SPAN_COUNT(allocated, reserved);
 
         auto ptr = addr_;
         auto const sentinel = addr_ + size_;
         for (int i = 0; i < len_ && ptr < sentinel; i++) {
-            switch (codepoint_size(ptr)) {
+            switch (sequence_size(ptr, sentinel)) {
                 case 1:
-                    vec.push_back(char(std::tolower(*ptr++)));
+                    vec.push_back(char(std::tolower(u8(*ptr++))));
                     break;
                 case 2: {
-                    auto const w = *(u16 *) ptr;
+                    auto const w = u16(u8(ptr[0]) | u8(ptr[1]) << 8);
                     if (auto it = Uppercase2.find(w); it != Uppercase2.end()) {
                         for (auto const c: it->second)
                             vec.push_back(char(c));
@@ -112,7 +146,7 @@ namespace ppx::utf8 {
                     break;
                 }
                 case 3: {
-                    auto const w = (*(u32 *) ptr) & 0x00ffffff;
+                    auto const w = u32(u8(ptr[0]) | u8(ptr[1]) << 8 | u8(ptr[2]) << 16);
                     if (auto it = Uppercase3.find(w); it != Uppercase3.end()) {
                         for (auto c: it->second)
                             vec.push_back(char(c));
@@ -124,33 +158,142 @@ namespace ppx::utf8 {
                     }
                     break;
                 }
+                case 4:
+                    vec.insert(vec.end(), ptr, ptr + 4);
+                    ptr += 4;
+                    break;
             }
         }
-        vec.shrink_to_fit();
+        shrink(vec, reserved);
         return vec;
     }
 
-    // hash of scope
-    u32 scope::
-    hash() const noexcept {
-        return murmur::hash3(addr_, size_, 10);
+    // Transliteration to ASCII (into caller buffer).
+    int scope::
+    transliterate(char *const out) const noexcept {
+        auto const [consumed, written] = transliterate(addr_, size_, out);
+        // incomplete code-point at the end is copied as it is
+        if (consumed < std::size_t(size_))
+            std::memcpy(out + written, addr_ + consumed, size_ - consumed);
+        return int(written + size_ - consumed);
     }
 
-    uint scope::
-    codepoint_size(char const *const ptr) noexcept {
-        auto const c = static_cast<u8>(*ptr);
-        if (c >= 0xc2 && c <= 0xdf) return 2;
-        if (c >= 0xe0 && c <= 0xef) return 3;
+    std::vector<char> scope::
+    transliterate() const noexcept {
+        std::vector<char> vec(size_);
+        UTF8SPAN_COUNT(allocated, vec.capacity());
+        vec.resize(transliterate(vec.data()));
+        return vec;
+    }
+
+    std::pair<std::size_t, std::size_t> scope::
+    transliterate(char const *const ptr, std::size_t const size, char *const out) noexcept {
+        auto p = ptr;
+        auto o = out;
+        auto const sentinel = ptr + size;
+        while (p < sentinel) {
+            // ASCII passes through
+            auto const run = ascii::prefix(p, sentinel - p);
+            std::memcpy(o, p, run);
+            p += run;
+            o += run;
+            if (p >= sentinel)
+                break;
+
+            if (is_incomplete(p, sentinel))
+                break;
+            auto const n = sequence_size(p, sentinel);
+            std::string_view replacement{p, n};
+            if (n == 2) {
+                auto const w = u16(u8(p[0]) | u8(p[1]) << 8);
+                if (auto it = Transliteration2.find(w); it != Transliteration2.end())
+                    replacement = it->second;
+            } else if (n == 3) {
+                auto const w = u32(u8(p[0]) | u8(p[1]) << 8 | u8(p[2]) << 16);
+                if (auto it = Transliteration3.find(w); it != Transliteration3.end())
+                    replacement = it->second;
+            }
+            std::memcpy(o, replacement.data(), replacement.size());
+            o += replacement.size();
+            p += n;
+        }
+        return {std::size_t(p - ptr), std::size_t(o - out)};
+    }
+
+    // Number of terminal columns for code-point.
+    int scope::
+    codepoint_width(u32 const cp) noexcept {
+        if (cp < 0x20 || (cp >= 0x7f && cp < 0xa0))
+            return 0;   // control characters
+        if (cp < width_table::Zero[0].first)
+            return 1;
+
+        auto const in = [cp](auto const& table) {
+            auto const it = std::upper_bound(
+                    std::begin(table), std::end(table), cp,
+                    [](u32 const v, width_table::range const& r) { return v < r.first; });
+            return it != std::begin(table) && cp <= std::prev(it)->last;
+        };
+        if (in(width_table::Zero))
+            return 0;
+        if (cp >= width_table::Wide[0].first && in(width_table::Wide))
+            return 2;
         return 1;
     }
 
+    // Number of terminal columns needed to display the scope.
+    int scope::
+    width() const noexcept {
+        auto ptr = addr_;
+        auto const sentinel = addr_ + size_;
+        int width = 0;
+        while (ptr < sentinel) {
+            auto const run = ascii::printable_prefix(ptr, sentinel - ptr);
+            ptr += run;
+            width += int(run);
+            if (ptr >= sentinel)
+                break;
+
+            auto const n = sequence_size(ptr, sentinel);
+            width += codepoint_width(decode(ptr, n));
+            ptr += n;
+        }
+        return width;
+    }
+
+    // The longest leading part of the scope which fits in columns.
+    scope scope::
+    truncate(int const columns) const noexcept {
+        auto ptr = addr_;
+        auto const sentinel = addr_ + size_;
+        int width = 0;
+        int len = 0;
+        while (ptr < sentinel) {
+            auto const run = int(ascii::printable_prefix(ptr, std::min<i64>(sentinel - ptr, std::max(0, columns - width))));
+            ptr += run;
+            width += run;
+            len += run;
+            if (ptr >= sentinel)
+                break;
+
+            auto const n = sequence_size(ptr, sentinel);
+            auto const w = codepoint_width(decode(ptr, n));
+            if (width + w > columns)
+                break;
+            width += w;
+            len += 1;
+            ptr += n;
+        }
+        return {addr_, int(ptr - addr_), len};
+    }
+
     bool
     scope::is_word_boundary() const noexcept {
         switch (size_) {
             case 1:
-                return !(isalnum(addr_[0]) || addr_[0] == '_');
+                return !(isalnum(u8(addr_[0])) || addr_[0] == '_');
             case 2: {
-                auto const w = *(u16 *) addr_;
+                auto const w = u16(u8(addr_[0]) | u8(addr_[1]) << 8);
                 if (auto it = Uppercase2.find(w); it != Uppercase2.end())
                     return false;
                 if (auto it = Uppercase3.find(w); it != Uppercase3.end())
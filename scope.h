@@ -1,6 +1,12 @@
 #pragma once
 #include "murmur.h"
+#include "stats.h"
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <cctype>
@@ -14,56 +20,72 @@ namespace ppx::utf8 {
 
     class scope {
         friend class span;
+        friend class document;
+        friend class cursor;
+        friend class rope;
+        friend class fuzzy;
+        friend class transliterator;
     protected:
         // Constants (polish and german utf8 code-points).
         static const std::unordered_map<u16, std::vector<u8>> Uppercase2;
         static const std::unordered_map<u32, std::vector<u8>> Uppercase3;
         static const std::unordered_map<u16, std::vector<u8>> SmallLetters;
+        static const std::unordered_map<u16, std::string_view> Transliteration2;
+        static const std::unordered_map<u32, std::string_view> Transliteration3;
     protected:
         char const *addr_{};
         int size_{};    // number of bytes
         int len_{0};    // number of code-points
     public:
-        scope() = default;
-        virtual ~scope() = default;
+        constexpr scope() = default;
+        constexpr virtual ~scope() = default;
         scope(scope const&) = default;
         scope& operator=(scope const&) = default;
         scope(scope&&) = default;
         scope& operator=(scope&&) = default;
 
-        scope(char const *const ptr, int const size)
+        constexpr scope(char const *const ptr, int const size)
                 : addr_{ptr}, size_{size} {
         }
 
-        scope(char const *ptr, int const size, int const len)
+        constexpr scope(char const *ptr, int const size, int const len)
                 : addr_{ptr}, size_{size}, len_{len} {
         }
 
         /// Returns number of bytes.
-        [[nodiscard]] int size() const noexcept {
+        [[nodiscard]] constexpr int size() const noexcept {
             return size_;
         }
 
         /// Returns number of code-points
-        [[nodiscard]] int len() const noexcept {
+        [[nodiscard]] constexpr int len() const noexcept {
             return len_;
         }
 
         /// Adds two scopes. The added scopes must create continuity.
-        scope& operator+=(scope const& rhs) noexcept;
+        constexpr scope& operator+=(scope const& rhs) noexcept {
+            // The beginning of rhs must be the end of me.
+            // The added scopes must create continuity.
+            if ((addr_ + size_) == rhs.addr_) {
+                size_ += rhs.size_;
+                if (len_ != -1 && rhs.len_ != -1)
+                    len_ += rhs.len_;
+            }
+            return *this;
+        }
 
         /// Checks if contains any valid code-point
-        [[nodiscard]] bool valid_chars() const noexcept {
+        [[nodiscard]] constexpr bool valid_chars() const noexcept {
             return len_ > 0;
         }
 
         /// Checks if contains any byte.
-        [[nodiscard]] bool empty() const noexcept {
+        [[nodiscard]] constexpr bool empty() const noexcept {
             return size_ == 0;
         }
 
         /// Returs pair: address of first byte and number of bytes in scope.
-        std::pair<char const *, int> operator()() const noexcept {
+        constexpr std::pair<char const *, int> operator()() const noexcept {
             return {addr_, size_};
         }
 
@@ -73,7 +95,19 @@ namespace ppx::utf8 {
         }
 
         /// Computes hash for specified scope.
-        [[nodiscard]] u32 hash() const noexcept;
+        [[nodiscard]] constexpr u32 hash() const noexcept {
+            if (!std::is_constant_evaluated())
+                UTF8SPAN_COUNT(hashes, 1);
+            return murmur::hash3(addr_, u32(size_), 10);
+        }
+
+        /// Computes number of terminal columns needed to display the scope
+        /// (wide East Asian characters take two columns, combining marks none).
+        [[nodiscard]] int width() const noexcept;
+
+        /// Returns the longest leading part of the scope which fits in passed
+        /// number of columns (zero-copy, wide character is never split).
+        [[nodiscard]] scope truncate(int columns) const noexcept;
 
         /// Converts all code-point to it uppercase version (if needed).
         [[nodiscard]] std::vector<char> to_upper() const noexcept;
@@ -81,11 +115,170 @@ namespace ppx::utf8 {
         /// Converts all code-points to it small versions (if needed).
         [[nodiscard]] std::vector<char> to_lower() const noexcept;
 
+        /// Replaces polish and german letters with ASCII (Ł -> L, ä -> ae, ß -> ss),
+        /// other code-points are copied as they are.
+        /// \param out - buffer for at least size() bytes (result is never longer).
+        /// \return number of bytes written.
+        int transliterate(char *out) const noexcept;
+
+        /// Transliterated copy of the scope (see above).
+        [[nodiscard]] std::vector<char> transliterate() const noexcept;
+
+        /// Decodes code-point of n bytes (see codepoint_size).
+        static constexpr u32 decode(char const *const ptr, uint const n) noexcept {
+            auto const c = static_cast<u8>(ptr[0]);
+            switch (n) {
+                case 2:
+                    return u32(c & 0x1f) << 6 | (u8(ptr[1]) & 0x3f);
+                case 3:
+                    return u32(c & 0x0f) << 12 | u32(u8(ptr[1]) & 0x3f) << 6 | (u8(ptr[2]) & 0x3f);
+                case 4:
+                    return u32(c & 0x07) << 18 | u32(u8(ptr[1]) & 0x3f) << 12
+                           | u32(u8(ptr[2]) & 0x3f) << 6 | (u8(ptr[3]) & 0x3f);
+                default:
+                    return c;
+            }
+        }
+
+        /// Returns number of terminal columns for code-point (0, 1 or 2).
+        static int codepoint_width(u32 cp) noexcept;
+
+        /// Counts code-points in passed buffer.
+        static constexpr int codepoints(char const *ptr, int const size) noexcept {
+            auto const sentinel = ptr + size;
+            int n = 0;
+            while (ptr < sentinel) {
+                ptr += sequence_size(ptr, sentinel);
+                n += 1;
+            }
+            return n;
+        }
+
     protected:
         /// Checks if code-point is word boundary
         [[nodiscard]] bool is_word_boundary() const noexcept;
 
+        /// Transliterates code-points of the buffer (stops before an incomplete
+        /// one at the end, see is_incomplete; invalid bytes are copied).
+        /// \return numbers of bytes consumed and written.
+        static std::pair<std::size_t, std::size_t>
+        transliterate(char const *ptr, std::size_t size, char *out) noexcept;
+
         /// Checks how many bytes contains pointed code-point.
-        static uint codepoint_size(char const *ptr) noexcept;
+        static constexpr uint codepoint_size(char const *const ptr) noexcept {
+            auto const c = static_cast<u8>(*ptr);
+            if (c >= 0xc2 && c <= 0xdf) return 2;
+            if (c >= 0xe0 && c <= 0xef) return 3;
+            if (c >= 0xf0 && c <= 0xf4) return 4;
+            return 1;
+        }
+
+        /// Checks if byte is a continuation byte (10xxxxxx).
+        static constexpr bool is_continuation(char const c) noexcept {
+            return (static_cast<u8>(c) & 0xc0) == 0x80;
+        }
+
+        /// Checks how many bytes contains pointed code-point, taking into account
+        /// what really follows the lead byte: truncated sequence or one without
+        /// continuation bytes is a single (invalid) byte. \n
+        /// Every byte which is not a continuation starts a code-point,
+        /// so the text can be stepped back (see backward) exactly the same way.
+        static constexpr uint sequence_size(char const *const ptr, char const *const sentinel) noexcept {
+            auto const n = codepoint_size(ptr);
+            if (sentinel - ptr < n)
+                return 1;
+            for (uint i = 1; i < n; i++)
+                if (!is_continuation(ptr[i]))
+                    return 1;
+            return n;
+        }
+
+        /// Checks if the buffer ends with beginning of a code-point (lead byte
+        /// followed only by continuation bytes up to the sentinel), which may be
+        /// completed by the next chunk of a stream.
+        static constexpr bool is_incomplete(char const *const ptr, char const *const sentinel) noexcept {
+            if (sentinel - ptr >= codepoint_size(ptr))
+                return false;
+            for (auto p = ptr + 1; p < sentinel; p++)
+                if (!is_continuation(*p))
+                    return false;
+            return true;
+        }
+
+        /// Returns scope for code-point at ptr and moves ptr after it.
+        /// Returns empty scope (ptr unchanged) at the end of the buffer.
+        static constexpr scope forward(char const *&ptr, char const *const sentinel) noexcept {
+            if (ptr < sentinel) {
+                auto const n = sequence_size(ptr, sentinel);
+                scope rv(ptr, int(n), 1);
+                ptr += n;
+                return rv;
+            }
+            return {};
+        }
+
+        /// Returns scope for code-point before ptr and moves ptr to it
+        /// (exact inverse of forward).
+        /// Returns empty scope (ptr unchanged) at the beginning of the buffer.
+        static constexpr scope backward(char const *&ptr, char const *const first) noexcept {
+            if (ptr > first) {
+                // the nearest byte which is not a continuation (at most 4 bytes back)
+                uint n = 1;
+                while (n < 4 && ptr - n > first && is_continuation(ptr[-int(n)]))
+                    n++;
+                auto const lead = ptr - n;
+                if (n > 1 && !is_continuation(*lead) && codepoint_size(lead) == n) {
+                    ptr = lead;
+                    return {ptr, int(n), 1};
+                }
+                ptr -= 1;
+                return {ptr, 1, 1};
+            }
+            return {};
+        }
+
+        /// forward for text known to be valid utf8 (lead byte gives the size).
+        static constexpr scope forward_valid(char const *&ptr, char const *const sentinel) noexcept {
+            if (ptr < sentinel) {
+                auto const n = codepoint_size(ptr);
+                scope rv(ptr, int(n), 1);
+                ptr += n;
+                return rv;
+            }
+            return {};
+        }
+
+        /// backward for text known to be valid utf8 (lead byte is the nearest non-continuation).
+        static constexpr scope backward_valid(char const *&ptr, char const *const first) noexcept {
+            if (ptr > first) {
+                auto const last = ptr;
+                while (is_continuation(*--ptr));
+                return {ptr, int(last - ptr), 1};
+            }
+            return {};
+        }
     };
+
+    /// Scope of a string literal with code-points and hash computed at compile time.
+    class literal : public scope {
+        u32 hash_{};
+    public:
+        constexpr literal(char const *const ptr, int const size)
+                : scope(ptr, size, codepoints(ptr, size)), hash_{scope::hash()} {
+        }
+
+        constexpr ~literal() override {}
+
+        /// Returns precomputed hash.
+        [[nodiscard]] constexpr u32 hash() const noexcept {
+            return hash_;
+        }
+    };
+
+    inline namespace literals {
+        /// "Łódź"_u8s - scope of utf8 literal (length and hash known at compile time).
+        consteval literal operator ""_u8s(char const *const ptr, std::size_t const size) {
+            return {ptr, int(size)};
+        }
+    }
 }
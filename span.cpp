@@ -2,9 +2,86 @@
 #include <cstring>
 
 namespace ppx::utf8 {
+    span::span(char const *const ptr, uint const size, validation const mode)
+            : span(ptr, size) {
+        validate(mode);
+    }
+
+    span::span(std::string const& str, validation const mode)
+            : span(str.c_str(), str.size()) {
+        own(str);
+        validate(mode);
+    }
+
+    // Validates the source in passed mode.
+    void span::
+    validate(validation const mode) {
+        if (mode == validation::none)
+            return;
+
+        valid_ = true;
+        auto const size = std::size_t(size_);
+        auto const bad = validator::first_invalid(addr_, size);
+        if (bad == size)
+            return;
+
+        error_ = uint(bad);
+        switch (mode) {
+            case validation::strict:
+                size_ = int(bad);
+                sentinel_ = addr_ + bad;
+                break;
+            case validation::replace:
+                own(validator::repair(addr_, size, validator::Replacement, bad));
+                break;
+            case validation::skip:
+                own(validator::repair(addr_, size, {}, bad));
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Copies state of other span.
+    void span::
+    assign(span const& other) {
+        cursor_ = other.cursor_;
+        sentinel_ = other.sentinel_;
+        idx_ = other.idx_;
+        saved_idx_ = other.saved_idx_;
+        saved_cursor_ = other.saved_cursor_;
+        store_ = other.store_;
+        error_ = other.error_;
+        valid_ = other.valid_;
+
+        if (other.addr_ == other.store_.data()) {
+            // Other owns the data - all pointers must be moved to my store.
+            auto const base = store_.data();
+            addr_ = base;
+            sentinel_ = base + (other.sentinel_ - other.addr_);
+            cursor_ = base + (other.cursor_ - other.addr_);
+            if (other.saved_cursor_)
+                saved_cursor_ = base + (other.saved_cursor_ - other.addr_);
+        }
+    }
+
+    // Takes ownership of passed string.
+    void span::
+    own(std::string str) {
+        store_ = std::move(str);
+        addr_ = store_.data();
+        cursor_ = addr_;
+        size_ = int(store_.size());
+        sentinel_ = addr_ + size_;
+        idx_ = 0;
+        saved_idx_ = 0;
+        saved_cursor_ = nullptr;
+    }
+
     // Rewind cursor to beginning of source.
     void span::
     begin() noexcept {
+        UTF8SPAN_COUNT(rewinds, 1);
         cursor_ = addr_;
         idx_ = 0;
     }
@@ -78,43 +155,25 @@ namespace ppx::utf8 {
     // Get scope for current utf8.
     scope span::
     next() noexcept {
-        if (cursor_ < sentinel_) {
-            auto const len = codepoint_size(cursor_);
-            if (cursor_ + len <= sentinel_) {
-                scope rv(cursor_, len, 1);
-                cursor_ += len;
-                idx_ += 1;
-                return rv;
-            }
+        auto rv = valid_ ? forward_valid(cursor_, sentinel_) : forward(cursor_, sentinel_);
+        if (rv.valid_chars()) {
+            UTF8SPAN_COUNT(steps, 1);
+            idx_ += 1;
         }
-        return {};
+        return rv;
     }
 
     // Get scope for previous utf8.
     scope span::
     prev() noexcept {
-        if (cursor_ > addr_ && cursor_ <= sentinel_) {
-            if (cursor_ - 3 >= addr_) {
-                if (codepoint_size(cursor_ - 3) == 3) {
-                    cursor_ -= 3;
-                    idx_ -= 1;
-                    return {cursor_, 3, 1};
-                }
-            }
-            if (cursor_ - 2 >= addr_) {
-                if (codepoint_size(cursor_ - 2) == 2) {
-                    cursor_ -= 2;
-                    idx_ -= 1;
-                    return {cursor_, 2, 1};
-                }
-            }
-            if (cursor_ - 1 >= addr_) {
-                cursor_ -= 1;
-                idx_ -= 1;
-                return {cursor_, 1, 1};
-            }
+        if (cursor_ > sentinel_)
+            return {};
+        auto rv = valid_ ? backward_valid(cursor_, addr_) : backward(cursor_, addr_);
+        if (rv.valid_chars()) {
+            UTF8SPAN_COUNT(steps, 1);
+            idx_ -= 1;
         }
-        return {};
+        return rv;
     }
 
     std::optional<std::pair<uint,scope>> span::
@@ -133,6 +192,7 @@ namespace ppx::utf8 {
         for (int idx = start_idx;; idx++) {
             auto sub = subspan(idx, sc.len_);
             if (0 == sub.len_) break;
+            UTF8SPAN_COUNT(candidates, 1);
             if (sub.size_ == sc.size_) {
                 if (0 == memcmp(sub.addr_, sc.addr_, sc.size_)) {
                     start_idx = idx + 1;
@@ -2,6 +2,7 @@
 
 #include "scope.h"
 #include "murmur.h"
+#include "validator.h"
 #include <string>
 #include <vector>
 #include <optional>
@@ -15,11 +16,26 @@ namespace ppx::utf8 {
         uint saved_idx_{};
         char const *saved_cursor_{};
         std::string store_{};
+        std::optional<uint> error_{};   // offset of first invalid byte in source
+        bool valid_{};                  // validated (stepping needs no checks)
     public:
         span() = delete;
 
         ~span() override = default;
 
+        span(span const& other)
+                : scope(other), sentinel_{} {
+            assign(other);
+        }
+
+        span& operator=(span const& other) {
+            if (this != &other) {
+                scope::operator=(other);
+                assign(other);
+            }
+            return *this;
+        }
+
         explicit span(std::string const& str)
                 : span(str.c_str(), str.size()) {
             store_ = str;
@@ -29,6 +45,23 @@ namespace ppx::utf8 {
                 : scope(ptr, int(size)), cursor_{ptr}, sentinel_{ptr + size} {
         }
 
+        /// Span over own copy of the string, validated in passed mode.
+        span(std::string const& str, validation mode);
+
+        /// Span validated in passed mode (in replace and skip modes, \n
+        /// if the source is invalid, span owns the repaired copy).
+        span(char const *ptr, uint size, validation mode);
+
+        /// Checks if span was validated (its text is valid utf8).
+        [[nodiscard]] bool validated() const noexcept {
+            return valid_;
+        }
+
+        /// Returns offset of first invalid byte in source (if found during validation).
+        [[nodiscard]] std::optional<uint> error() const noexcept {
+            return error_;
+        }
+
         /// Rewind cursor to beginning of source.
         void begin() noexcept;
 
@@ -63,6 +96,12 @@ namespace ppx::utf8 {
         /// After success cursor in moved to the utf8's position.
         scope prev() noexcept;
 
+        /// Returns the longest leading part of the span which fits
+        /// in passed number of terminal columns (zero-copy).
+        [[nodiscard]] scope truncate(uint const columns) const noexcept {
+            return scope(addr_, size_).truncate(int(columns));
+        }
+
         /// Searches passed scope in the entire buffer.
         [[nodiscard]] std::optional<std::pair<uint, scope>>
         search(scope const& sc, int start_pos = 0) noexcept;
@@ -82,6 +121,15 @@ namespace ppx::utf8 {
             saved_cursor_ = cursor_;
         }
 
+        /// Copies state of other span (pointers are moved to own store if needed).
+        void assign(span const& other);
+
+        /// Validates the source in passed mode.
+        void validate(validation mode);
+
+        /// Takes ownership of passed string and points span to it.
+        void own(std::string str);
+
         /// Restores saved state of span.
         void restore() noexcept {
             idx_ = saved_idx_;
@@ -0,0 +1,72 @@
+#include "split.h"
+#include "ascii.h"
+#include <cstring>
+
+namespace ppx::utf8 {
+    namespace {
+        // Scope of passed bytes with number of code-points.
+        scope make_scope(char const *const first, char const *const last) noexcept {
+            auto const size = std::size_t(last - first);
+            auto const run = ascii::prefix(first, size);
+            return {first, int(size), int(run) + scope::codepoints(first + run, int(size - run))};
+        }
+
+        char const *find(char const *const first, char const *const last, char const c) noexcept {
+            return static_cast<char const *>(std::memchr(first, c, std::size_t(last - first)));
+        }
+    }
+
+    // Next line.
+    lines::iterator& lines::iterator::
+    operator++() noexcept {
+        if (ptr_ >= sentinel_) {
+            done_ = true;
+            return *this;
+        }
+
+        auto const nl = find(ptr_, sentinel_, '\n');
+        auto last = nl ? nl : sentinel_;
+        if (last > ptr_ && last[-1] == '\r')
+            --last;
+        current_ = make_scope(ptr_, last);
+        ptr_ = nl ? nl + 1 : sentinel_;
+        return *this;
+    }
+
+    // Next field.
+    fields::iterator& fields::iterator::
+    operator++() noexcept {
+        if (ptr_ == nullptr) {
+            done_ = true;
+            return *this;
+        }
+
+        auto first = ptr_;
+        auto last = sentinel_;
+        auto from = ptr_;   // where to look for delimiter
+        if (quote_ && ptr_ < sentinel_ && *ptr_ == quote_) {
+            first = ptr_ + 1;
+            from = sentinel_;
+            for (auto p = first; p < sentinel_;) {
+                auto const q = find(p, sentinel_, quote_);
+                if (q == nullptr)
+                    break;
+                if (q + 1 < sentinel_ && q[1] == quote_) {
+                    p = q + 2;  // escaped quote
+                    continue;
+                }
+                last = q;
+                from = q + 1;
+                break;
+            }
+        }
+
+        auto const d = find(from, sentinel_, delimiter_);
+        auto const end = d ? d : sentinel_;
+        if (from == ptr_ || from < end)
+            last = end;     // not quoted, or bytes after closing quote (kept with it)
+        current_ = make_scope(first, last);
+        ptr_ = d ? d + 1 : nullptr;
+        return *this;
+    }
+}
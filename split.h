@@ -0,0 +1,134 @@
+#pragma once
+
+#include "scope.h"
+#include <cstddef>
+#include <iterator>
+
+namespace ppx::utf8 {
+
+    /// Lazy view of lines (LF or CRLF terminated) of a scope/span. \n
+    /// Every line is a zero-copy scope (without terminator)
+    /// with number of code-points.
+    class lines {
+        char const *addr_;
+        char const *sentinel_;
+    public:
+        class iterator {
+            char const *ptr_{};         // beginning of next line
+            char const *sentinel_{};
+            scope current_{};
+            bool done_{true};
+        public:
+            using value_type = scope;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(char const *const ptr, char const *const sentinel) noexcept
+                    : ptr_{ptr}, sentinel_{sentinel}, done_{false} {
+                ++*this;
+            }
+
+            scope const& operator*() const noexcept {
+                return current_;
+            }
+
+            scope const *operator->() const noexcept {
+                return &current_;
+            }
+
+            iterator& operator++() noexcept;
+
+            iterator operator++(int) noexcept {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept {
+                return done_;
+            }
+        };
+
+        explicit lines(scope const& sc) noexcept
+                : addr_{sc().first}, sentinel_{sc().first + sc().second} {
+        }
+
+        [[nodiscard]] iterator begin() const noexcept {
+            return {addr_, sentinel_};
+        }
+
+        [[nodiscard]] std::default_sentinel_t end() const noexcept {
+            return {};
+        }
+    };
+
+    /// Lazy view of delimiter separated fields (CSV, TSV) of a scope/span. \n
+    /// When quote is set, field starting with it may contain delimiters;
+    /// the field is then returned without outer quotes (doubled quotes
+    /// inside are left as they are - the view never copies). Bytes between
+    /// closing quote and delimiter are not dropped: "ab"cd gives ab"cd. \n
+    /// Empty source has no fields.
+    class fields {
+        char const *addr_;
+        char const *sentinel_;
+        char delimiter_;
+        char quote_;
+    public:
+        class iterator {
+            char const *ptr_{};         // beginning of next field (nullptr after the last one)
+            char const *sentinel_{};
+            char delimiter_{};
+            char quote_{};
+            scope current_{};
+            bool done_{true};
+        public:
+            using value_type = scope;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(char const *const ptr, char const *const sentinel, char const delimiter, char const quote) noexcept
+                    : ptr_{ptr == sentinel ? nullptr : ptr}, sentinel_{sentinel},
+                      delimiter_{delimiter}, quote_{quote}, done_{false} {
+                ++*this;
+            }
+
+            scope const& operator*() const noexcept {
+                return current_;
+            }
+
+            scope const *operator->() const noexcept {
+                return &current_;
+            }
+
+            iterator& operator++() noexcept;
+
+            iterator operator++(int) noexcept {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept {
+                return done_;
+            }
+        };
+
+        /// \param sc - record to split,
+        /// \param delimiter - field separator (e.g. ',' or '\\t'),
+        /// \param quote - quoting character or 0 when fields are not quoted.
+        fields(scope const& sc, char const delimiter, char const quote = 0) noexcept
+                : addr_{sc().first}, sentinel_{sc().first + sc().second},
+                  delimiter_{delimiter}, quote_{quote} {
+        }
+
+        [[nodiscard]] iterator begin() const noexcept {
+            return {addr_, sentinel_, delimiter_, quote_};
+        }
+
+        [[nodiscard]] std::default_sentinel_t end() const noexcept {
+            return {};
+        }
+    };
+}
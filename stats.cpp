@@ -0,0 +1,86 @@
+#include "stats.h"
+
+#ifdef UTF8SPAN_STATS
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace ppx::utf8 {
+#ifdef UTF8SPAN_STATS
+    namespace {
+        constexpr auto Relaxed = std::memory_order_relaxed;
+
+        void add(stats::counters& to, stats::slot const& from) noexcept {
+            to.steps += from.steps.load(Relaxed);
+            to.rewinds += from.rewinds.load(Relaxed);
+            to.candidates += from.candidates.load(Relaxed);
+            to.allocated += from.allocated.load(Relaxed);
+            to.hashes += from.hashes.load(Relaxed);
+        }
+
+        // All live slots and the sum of slots of finished threads.
+        struct registry {
+            std::mutex mutex{};
+            std::vector<stats::slot const *> slots{};
+            stats::counters finished{};
+
+            static registry& instance() {
+                static registry r{};
+                return r;
+            }
+        };
+
+        // Slot of the thread, registered for its lifetime.
+        struct owner {
+            stats::slot slot{};
+
+            owner() {
+                auto& r = registry::instance();
+                std::lock_guard lock{r.mutex};
+                r.slots.push_back(&slot);
+            }
+
+            ~owner() {
+                auto& r = registry::instance();
+                std::lock_guard lock{r.mutex};
+                add(r.finished, slot);
+                r.slots.erase(std::find(r.slots.begin(), r.slots.end(), &slot));
+            }
+        };
+    }
+
+    stats::slot& stats::
+    local() noexcept {
+        thread_local owner o{};
+        return o.slot;
+    }
+
+    stats::counters stats::
+    thread() noexcept {
+        counters rv{};
+        add(rv, local());
+        return rv;
+    }
+
+    stats::counters stats::
+    total() {
+        auto& r = registry::instance();
+        std::lock_guard lock{r.mutex};
+        auto rv = r.finished;
+        for (auto const slot: r.slots)
+            add(rv, *slot);
+        return rv;
+    }
+#else
+    stats::counters stats::
+    thread() noexcept {
+        return {};
+    }
+
+    stats::counters stats::
+    total() {
+        return {};
+    }
+#endif
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+// Hot-path instrumentation (opt-in).
+// Counters are compiled in only when UTF8SPAN_STATS is defined
+// (cmake -DUTF8SPAN_STATS=ON), otherwise UTF8SPAN_COUNT expands to nothing.
+#ifdef UTF8SPAN_STATS
+#define UTF8SPAN_COUNT(counter, n) ::ppx::utf8::stats::bump(::ppx::utf8::stats::local().counter, (n))
+#else
+#define UTF8SPAN_COUNT(counter, n) ((void)0)
+#endif
+
+namespace ppx::utf8 {
+    class stats {
+    public:
+        using u64 = uint64_t;
+
+        /// Snapshot of counters.
+        struct counters {
+            u64 steps{};        // code-points stepped by next()/prev()/skip()
+            u64 rewinds{};      // cursor rewinds by begin()
+            u64 candidates{};   // positions tested by search()
+            u64 allocated{};    // bytes allocated by transforms
+            u64 hashes{};       // hash() calls
+
+            /// Calls f(name, value) for every counter (for metrics exporters).
+            template<typename F>
+            void visit(F&& f) const {
+                f(std::string_view{"steps"}, steps);
+                f(std::string_view{"rewinds"}, rewinds);
+                f(std::string_view{"candidates"}, candidates);
+                f(std::string_view{"allocated"}, allocated);
+                f(std::string_view{"hashes"}, hashes);
+            }
+        };
+
+        /// Returns whether counters are compiled in.
+        static constexpr bool enabled() noexcept {
+#ifdef UTF8SPAN_STATS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /// Counters of the calling thread.
+        static counters thread() noexcept;
+
+        /// Sum of counters of all threads (live and finished).
+        /// Safe to call from any thread, e.g. by a metrics exporter.
+        static counters total();
+
+#ifdef UTF8SPAN_STATS
+        /// Counters of one thread (written only by the owner thread).
+        struct slot {
+            std::atomic<u64> steps{};
+            std::atomic<u64> rewinds{};
+            std::atomic<u64> candidates{};
+            std::atomic<u64> allocated{};
+            std::atomic<u64> hashes{};
+        };
+
+        static slot& local() noexcept;
+
+        /// Single writer - no read-modify-write instruction needed.
+        static void bump(std::atomic<u64>& counter, u64 const n) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+#endif
+    };
+}
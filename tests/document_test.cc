@@ -0,0 +1,138 @@
+#include "scope_test.h"
+#include "../document.h"
+#include "../cursor.h"
+#include "../span.h"
+#include <iostream>
+#include <thread>
+
+TEST_F(ScopeTest, document_index_operator) {
+    auto dt = executor([&] {
+        for (auto const indexed: {false, true}) {
+            ppx::utf8::document const doc{text_two_, indexed};
+            ASSERT_EQ(doc.len(), 18);
+            ASSERT_EQ(doc.indexed(), indexed);
+
+            struct {
+                ppx::utf8::uint i;
+                std::string expected;
+            } tests[] = {
+                    {0,  "Ł"},
+                    {3,  "ź"},
+                    {12, "k"},
+                    {1,  "ó"},
+                    {17, "i"},
+                    {18, ""},
+            };
+
+            ppx::utf8::cursor cur{doc};
+            for (auto const& tt: tests) {
+                ASSERT_EQ(doc[tt.i].str(), tt.expected);
+                ASSERT_EQ(cur[tt.i].str(), tt.expected);
+            }
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::document_index_operator " << dt << '\n';
+}
+
+TEST_F(ScopeTest, document_subspan) {
+    auto dt = executor([&] {
+        ppx::utf8::document const doc{text_two_};
+
+        struct {
+            ppx::utf8::uint start;
+            ppx::utf8::uint len;
+            std::string expected;
+        } tests[] = {
+                {0, 0,  ""},
+                {0, 4,  "Łódź"},
+                {8, 10, "czółkowski"},
+                {8, 11, ""},
+        };
+        for (auto const& tt: tests) {
+            auto const sc = doc.subspan(tt.start, tt.len);
+            ASSERT_EQ(sc.str(), tt.expected);
+            ASSERT_EQ(sc.len(), tt.expected.empty() ? 0 : int(tt.len));
+        }
+        ASSERT_EQ(doc.subspan(8).str(), "czółkowski");
+        ASSERT_EQ(doc.subspan(18).str(), "");
+        ASSERT_EQ(doc().len(), 18);
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::document_subspan " << dt << '\n';
+}
+
+TEST_F(ScopeTest, document_search) {
+    auto dt = executor([&] {
+        ppx::utf8::document const doc{text_two_};
+
+        struct {
+            std::string c;
+            ppx::utf8::uint start;
+            std::optional<ppx::utf8::uint> pos;
+        } tests[] = {
+                {"ź",    0,  3},
+                {"ó",    0,  1},
+                {"ó",    2,  10},
+                {"ółk",  0,  10},
+                {"Ł",    1,  {}},
+                {"ki",   0,  16},
+                {"Ó",    0,  {}},
+                {"d",    19, {}},
+                {"\xc3", 0,  {}},     // lead byte alone ends inside "ó"
+        };
+
+        for (auto const& tt: tests) {
+            auto const opt = doc.search(ppx::utf8::span{tt.c}(), tt.start);
+            ASSERT_EQ(opt.has_value(), tt.pos.has_value());
+            if (opt) {
+                ASSERT_EQ(opt->first, *tt.pos);
+                ASSERT_EQ(opt->second.str(), tt.c);
+            }
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::document_search " << dt << '\n';
+}
+
+TEST_F(ScopeTest, cursor_shared) {
+    auto dt = executor([&] {
+        std::string text{};
+        for (int i = 0; i < 1000; i++)
+            text += text_two_;
+        ppx::utf8::document const doc{text, true};
+
+        auto worker = [&doc](bool forward, int *count) {
+            ppx::utf8::cursor cur{doc};
+            if (forward) {
+                while (cur.next().valid_chars())
+                    ++*count;
+            } else {
+                cur.end();
+                while (cur.prev().valid_chars())
+                    ++*count;
+            }
+        };
+
+        int counts[4]{};
+        std::thread threads[] = {
+                std::thread(worker, true, &counts[0]),
+                std::thread(worker, false, &counts[1]),
+                std::thread(worker, true, &counts[2]),
+                std::thread(worker, false, &counts[3]),
+        };
+        for (auto& t: threads)
+            t.join();
+        for (auto const n: counts)
+            ASSERT_EQ(n, doc.len());
+
+        ppx::utf8::cursor cur{doc};
+        ASSERT_TRUE(cur.skip(17999));
+        ASSERT_EQ(cur.next().str(), "i");
+        ASSERT_FALSE(cur.skip(1));
+        ASSERT_EQ(cur[0].str(), "Ł");
+        ASSERT_EQ(cur.index(), 1);
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::cursor_shared " << dt << '\n';
+}
@@ -0,0 +1,126 @@
+#include "scope_test.h"
+#include "../fuzzy.h"
+#include "../span.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace {
+    // Reference: optimal string alignment distance on code-points.
+    uint reference(std::string const& a, std::string const& b, bool transpositions) {
+        auto cps = [](std::string const& s) {
+            std::vector<std::string> rv{};
+            ppx::utf8::span span{s};
+            for (auto sc = span.next(); sc.valid_chars(); sc = span.next())
+                rv.push_back(sc.str());
+            return rv;
+        };
+        auto const x = cps(a);
+        auto const y = cps(b);
+        std::vector<std::vector<uint>> d(x.size() + 1, std::vector<uint>(y.size() + 1));
+        for (std::size_t i = 0; i <= x.size(); i++) d[i][0] = uint(i);
+        for (std::size_t j = 0; j <= y.size(); j++) d[0][j] = uint(j);
+        for (std::size_t i = 1; i <= x.size(); i++)
+            for (std::size_t j = 1; j <= y.size(); j++) {
+                d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (x[i - 1] != y[j - 1])});
+                if (transpositions && i > 1 && j > 1 && x[i - 1] == y[j - 2] && x[i - 2] == y[j - 1])
+                    d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        return d[x.size()][y.size()];
+    }
+}
+
+TEST_F(ScopeTest, fuzzy_distance) {
+    auto dt = executor([&] {
+        using ppx::utf8::folding;
+        struct {
+            std::string a;
+            std::string b;
+            folding f;
+            bool transpositions;
+            uint expected;
+        } tests[] = {
+                {"kitten",  "sitting", folding::none,       false, 3},
+                {"",        "Łódź",    folding::none,       false, 4},
+                {"Łódź",    "",        folding::none,       false, 4},
+                {"Łódź",    "Lodz",    folding::none,       false, 3},
+                {"Łódź",    "Lodz",    folding::diacritics, false, 0},
+                {"ŁÓDŹ",    "łódź",    folding::icase,      false, 0},
+                {"ŁÓDŹ",    "lodz",    folding::both,       false, 0},
+                {"Straße",  "STRASSE", folding::both,       false, 1},
+                {"ẞ",       "ß",       folding::icase,      false, 0},
+                {"Müller",  "Mueller", folding::diacritics, false, 1},
+                {"ab",      "ba",      folding::none,       false, 2},
+                {"ab",      "ba",      folding::none,       true,  1},
+                {"Łódź",    "Łdóź",    folding::none,       true,  1},
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::fuzzy const fz{ppx::utf8::span{tt.a}(), tt.f, tt.transpositions};
+            ASSERT_EQ(fz.distance(ppx::utf8::span{tt.b}()), tt.expected) << tt.a << " - " << tt.b;
+            ASSERT_EQ(fz.distance(ppx::utf8::span{tt.b}(), tt.expected), tt.expected);
+            if (tt.expected > 0) {
+                ASSERT_FALSE(fz.distance(ppx::utf8::span{tt.b}(), tt.expected - 1).has_value());
+            }
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::fuzzy_distance " << dt << '\n';
+}
+
+TEST_F(ScopeTest, fuzzy_random) {
+    auto dt = executor([&] {
+        std::mt19937 gen{7};
+        std::string const alphabet[] = {"a", "b", "ł", "ó", "L", "ẞ"};
+        auto random_text = [&](std::size_t n) {
+            std::string rv{};
+            for (std::size_t i = 0; i < n; i++)
+                rv += alphabet[gen() % std::size(alphabet)];
+            return rv;
+        };
+
+        for (int step = 0; step < 300; step++) {
+            // Short patterns go bit-parallel, long ones (> 64) use the classic algorithm.
+            auto const a = random_text(step % 3 == 0 ? 70 + gen() % 10 : gen() % 20);
+            auto const b = random_text(gen() % 80);
+            auto const transpositions = bool(step % 2);
+            ppx::utf8::fuzzy const fz{ppx::utf8::span{a}(), ppx::utf8::folding::none, transpositions};
+            ASSERT_EQ(fz.distance(ppx::utf8::span{b}()), reference(a, b, transpositions));
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::fuzzy_random " << dt << '\n';
+}
+
+TEST_F(ScopeTest, fuzzy_search) {
+    auto dt = executor([&] {
+        using ppx::utf8::folding;
+        struct {
+            std::string pattern;
+            uint k;
+            folding f;
+            std::optional<uint> end;
+            uint distance;
+        } tests[] = {
+                {"Pszczółkowski", 0, folding::none,       18, 0},
+                {"Pszczulkowski", 1, folding::none,       {}, 0},
+                {"Pszczulkowski", 2, folding::none,       18, 2},
+                {"pszczolkowski", 0, folding::both,       18, 0},
+                {"lodz",          0, folding::both,       4,  0},
+                {"Lodz",          1, folding::none,       {}, 0},
+                {"Krakow",        2, folding::none,       {}, 0},
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::fuzzy const fz{ppx::utf8::span{tt.pattern}(), tt.f};
+            auto const hit = fz.search(ppx::utf8::scope(text_two_.data(), int(text_two_.size())), tt.k);
+            ASSERT_EQ(hit.has_value(), tt.end.has_value()) << tt.pattern;
+            if (hit) {
+                ASSERT_EQ(hit->end, *tt.end);
+                ASSERT_EQ(hit->distance, tt.distance);
+            }
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::fuzzy_search " << dt << '\n';
+}
@@ -0,0 +1,136 @@
+#include "scope_test.h"
+#include "../rope.h"
+#include "../span.h"
+#include <iostream>
+#include <random>
+
+namespace {
+    // Reference model: one string per code-point.
+    std::vector<std::string> split_codepoints(std::string const& text) {
+        std::vector<std::string> rv{};
+        ppx::utf8::span span{text};
+        for (auto sc = span.next(); sc.valid_chars(); sc = span.next())
+            rv.push_back(sc.str());
+        return rv;
+    }
+
+    std::string join(std::vector<std::string> const& cps, std::size_t first = 0, std::size_t n = std::string::npos) {
+        std::string rv{};
+        for (auto i = first; i < cps.size() && i - first < n; i++)
+            rv += cps[i];
+        return rv;
+    }
+}
+
+TEST_F(ScopeTest, rope_edit) {
+    auto dt = executor([&] {
+        ppx::utf8::rope rope{text_two_};
+        ASSERT_EQ(rope.len(), 18);
+        ASSERT_EQ(rope[3].str(), "ź");
+
+        ASSERT_TRUE(rope.insert(4, " i Żnin"));
+        ASSERT_EQ(rope.str(), "Łódź i Żnin Pszczółkowski");
+        ASSERT_TRUE(rope.erase(0, 7));
+        ASSERT_EQ(rope.str(), "Żnin Pszczółkowski");
+        ASSERT_TRUE(rope.insert(rope.len(), "!"));
+        ASSERT_EQ(rope.subspan(5, 5).str(), "Pszcz");
+        ASSERT_EQ(rope.subspan(10).str(), "ółkowski!");
+        ASSERT_FALSE(rope.insert(100, "x"));
+        ASSERT_FALSE(rope.erase(18, 2));
+        ASSERT_TRUE(rope.subspan(19).empty());
+
+        // malformed bytes glued by an edit: rope agrees with span over the same bytes
+        auto const agrees = [](ppx::utf8::rope const& r) {
+            auto const cps = split_codepoints(r.str());
+            if (r.len() != int(cps.size()))
+                return false;
+            for (std::size_t i = 0; i < cps.size(); i++)
+                if (r[uint(i)].str() != cps[i])
+                    return false;
+            return true;
+        };
+        ppx::utf8::rope seam{"a\xc3"};
+        ASSERT_TRUE(seam.insert(2, "\xb3"));
+        ASSERT_EQ(seam.len(), 2);
+        ASSERT_EQ(seam[1].str(), "ó");
+        ASSERT_TRUE(seam.insert(1, "x"));
+        ASSERT_TRUE(seam.erase(1, 1));
+        ASSERT_EQ(seam.str(), "a\xc3\xb3");
+        ASSERT_TRUE(agrees(seam));
+        seam = ppx::utf8::rope{"\xc3x\xb3"};
+        ASSERT_TRUE(seam.erase(1, 1));
+        ASSERT_EQ(seam.len(), 1);
+        ASSERT_TRUE(agrees(seam));
+
+        // ... also when pieces are too big to be copied together
+        ppx::utf8::rope big{std::string(1024, 'a') + "\xf0"};
+        ASSERT_TRUE(big.insert(uint(big.len()), "\x9f\x98\x80" + std::string(600, 'b')));
+        ASSERT_EQ(big.len(), 1024 + 1 + 600);
+        ASSERT_EQ(big[1024].str(), "😀");
+        ASSERT_TRUE(agrees(big));
+
+        // moved-from rope is empty and its cursor does not point into moved nodes
+        rope.begin();
+        rope.next();
+        ppx::utf8::rope moved{std::move(rope)};
+        ASSERT_TRUE(moved.insert(0, "x"));
+        ASSERT_TRUE(rope.empty());
+        ASSERT_FALSE(rope.next().valid_chars());
+        ASSERT_FALSE(rope.prev().valid_chars());
+        rope = std::move(moved);
+        ASSERT_EQ(rope.next().str(), "x");
+        ASSERT_FALSE(moved.next().valid_chars());
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::rope_edit " << dt << '\n';
+}
+
+TEST_F(ScopeTest, rope_random) {
+    auto dt = executor([&] {
+        std::string text{};
+        for (int i = 0; i < 100; i++)
+            text += text_two_ + " ẞÄÖÜ 😀\n";
+        ppx::utf8::rope rope{text};
+        auto model = split_codepoints(text);
+
+        std::mt19937 gen{2024};
+        std::string const inserts[] = {"ą", "Straße", "x", "ółko 😀", text_two_};
+        for (int step = 0; step < 500; step++) {
+            auto const idx = uint(gen() % (model.size() + 1));
+            if (gen() % 2) {
+                auto const& s = inserts[gen() % std::size(inserts)];
+                ASSERT_TRUE(rope.insert(idx, s));
+                auto const cps = split_codepoints(s);
+                model.insert(model.begin() + idx, cps.begin(), cps.end());
+            } else {
+                auto const n = uint(std::min<std::size_t>(gen() % 20, model.size() - idx));
+                ASSERT_TRUE(rope.erase(idx, n));
+                model.erase(model.begin() + idx, model.begin() + idx + n);
+            }
+            ASSERT_EQ(rope.len(), int(model.size()));
+
+            if (!model.empty()) {
+                auto const i = gen() % model.size();
+                ASSERT_EQ(rope[uint(i)].str(), model[i]);
+                auto const n = gen() % 30 + 1;
+                auto const sub = rope.subspan(uint(i), uint(n));
+                ASSERT_EQ(sub.str(), i + n <= model.size() ? join(model, i, n) : "");
+            }
+        }
+        ASSERT_EQ(rope.str(), join(model));
+        ASSERT_EQ(rope.size(), int(join(model).size()));
+
+        std::size_t i = 0;
+        for (auto sc = rope.next(); sc.valid_chars(); sc = rope.next())
+            ASSERT_EQ(sc.str(), model[i++]);
+        ASSERT_EQ(i, model.size());
+        for (auto sc = rope.prev(); sc.valid_chars(); sc = rope.prev())
+            ASSERT_EQ(sc.str(), model[--i]);
+        ASSERT_EQ(i, 0);
+
+        rope.end();
+        ASSERT_EQ(rope.prev().str(), model.back());
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::rope_random " << dt << '\n';
+}
@@ -1,7 +1,11 @@
 #include "scope_test.h"
 #include "../scope.h"
 #include "../span.h"
+#include "../split.h"
+#include "../transliterator.h"
+#include "../stats.h"
 #include <iostream>
+#include <ranges>
 
 TEST_F(ScopeTest, prev) {
     auto dt = executor([&] {
@@ -18,7 +22,10 @@ TEST_F(ScopeTest, prev) {
                 "", {},
                 "ó", {{"ó", 2, 1}},
                 "ół", {{"ł", 2, 1}, {"ó", 2, 1}},
-                "ółko", {{"o", 1, 1}, {"k", 1, 1}, {"ł", 2, 1}, {"ó", 2, 1}}
+                "ółko", {{"o", 1, 1}, {"k", 1, 1}, {"ł", 2, 1}, {"ó", 2, 1}},
+                // malformed input: same units as next() yields, in reverse
+                "\xc3\xc3\xb3", {{"ó", 2, 1}, {"\xc3", 1, 1}},
+                "a\xb3\xe2\x82", {{"\x82", 1, 1}, {"\xe2", 1, 1}, {"\xb3", 1, 1}, {"a", 1, 1}},
         };
 
         for (auto const& tt: tests) {
@@ -244,7 +251,8 @@ TEST_F(ScopeTest, tolower_test) {
             std::string expected;
         } tests[] = {
                 {"ŁÓDŹ ĄĘĆŃ Żnin", "łódź ąęćń żnin"},
-                {"ẞÄÖÜ ẞ Ä Ö Ü",   "ßäöü ß ä ö ü"}
+                {"ẞÄÖÜ ẞ Ä Ö Ü",   "ßäöü ß ä ö ü"},
+                {"Ä😀Ö",            "ä😀ö"},
         };
 
         for (auto const& tt: tests) {
@@ -265,6 +273,7 @@ TEST_F(ScopeTest, toupper) {
         } tests[] = {
                 {"ßäöü ß ä ö ü",   "ẞÄÖÜ ẞ Ä Ö Ü"},
                 {"łódź ąęćń żnin", "ŁÓDŹ ĄĘĆŃ ŻNIN",},
+                {"ä😀ö",            "Ä😀Ö"},
         };
 
         for (auto const& tt: tests) {
@@ -275,3 +284,304 @@ TEST_F(ScopeTest, toupper) {
     std::cout.fill('.');
     std::cout << std::setw(50) << std::left << "ScopeTest::to_upperr " << dt << '\n';
 }
+
+TEST_F(ScopeTest, literal) {
+    using namespace ppx::utf8::literals;
+
+    auto dt = executor([&] {
+        constexpr auto lodz = "Łódź"_u8s;
+        static_assert(lodz.size() == 7);
+        static_assert(lodz.len() == 4);
+        static_assert(lodz.hash() == ppx::utf8::scope("Łódź", 7).hash());
+        static_assert(ppx::utf8::scope::codepoints("ẞÄÖÜ", 9) == 4);
+
+        struct {
+            ppx::utf8::literal lit;
+            std::string text;
+        } tests[] = {
+                {""_u8s,                   ""},
+                {"Łódź"_u8s,               "Łódź"},
+                {"ẞ Ä Ö Ü"_u8s,            "ẞ Ä Ö Ü"},
+                {"Łódź Pszczółkowski"_u8s, "Łódź Pszczółkowski"},
+        };
+
+        for (auto const& tt: tests) {
+            auto const sc = ppx::utf8::span{tt.text}();
+            ASSERT_EQ(tt.lit.str(), tt.text);
+            ASSERT_EQ(tt.lit.len(), sc.len());
+            ASSERT_EQ(tt.lit.hash(), sc.hash());
+            ASSERT_EQ(tt.lit.hash(), ppx::murmur::hash3(tt.text.data(), tt.text.size(), 10));
+        }
+
+        switch (ppx::utf8::span{text_one_}().hash()) {
+            case "Łódź"_u8s.hash():
+                break;
+            default:
+                FAIL();
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::literal " << dt << '\n';
+}
+
+TEST_F(ScopeTest, width) {
+    auto dt = executor([&] {
+        struct {
+            std::string text;
+            int expected;
+        } tests[] = {
+                {"",                            0},
+                {"Łódź Pszczółkowski",          18},
+                {"a\tb",                        2},
+                {"e\xcc\x81",                   1},     // e + combining acute
+                {"日本語",                        6},
+                {"ｘ全角ｙ",                       8},
+                {"Straße ẞ",                    8},
+                {"0123456789abcdef0123456789",  26},
+        };
+
+        for (auto const& tt: tests)
+            ASSERT_EQ(ppx::utf8::span{tt.text}.width(), tt.expected);
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::width " << dt << '\n';
+}
+
+TEST_F(ScopeTest, truncate) {
+    auto dt = executor([&] {
+        struct {
+            std::string text;
+            ppx::utf8::uint columns;
+            std::string expected;
+            int len;
+        } tests[] = {
+                {"Łódź Pszczółkowski", 0,   "",          0},
+                {"Łódź Pszczółkowski", 4,   "Łódź",      4},
+                {"Łódź Pszczółkowski", 100, "Łódź Pszczółkowski", 18},
+                {"日本語",               5,   "日本",        2},
+                {"日本語",               1,   "",          0},
+                {"ae\xcc\x81x",        2,   "ae\xcc\x81", 3},
+                {"abcdefghijklmnop",   9,   "abcdefghi", 9},
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::span const span{tt.text};
+            auto const sc = span.truncate(tt.columns);
+            ASSERT_EQ(sc.str(), tt.expected);
+            ASSERT_EQ(sc.len(), tt.len);
+            ASSERT_LE(sc.width(), int(tt.columns));
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::truncate " << dt << '\n';
+}
+
+TEST_F(ScopeTest, validation) {
+    auto dt = executor([&] {
+        using ppx::utf8::validation;
+        struct {
+            std::string text;
+            std::optional<ppx::utf8::uint> error;
+            std::string strict;
+            std::string replace;
+            std::string skip;
+        } tests[] = {
+                {"Łódź",                 {},  "Łódź",  "Łódź",                  "Łódź"},
+                {"😀 ok",                {},  "😀 ok", "😀 ok",                 "😀 ok"},
+                {"ab\x80" "cd",          2,   "ab",    "ab�" "cd",         "abcd"},
+                {"\xc0\xaf" "x",         0,   "",      "��" "x",      "x"},      // overlong
+                {"a\xed\xa0\x80",        1,   "a",     "a���",   "a"},      // surrogate
+                {"Ł\xe2\x82",            2,   "Ł",     "Ł�",               "Ł"},      // truncated
+                {"\xf4\x90\x80\x80",     0,   "",      "����", ""},    // > U+10FFFF
+                {"0123456789\xf0\x9f\x98", 10, "0123456789", "0123456789�", "0123456789"},
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::span const strict{tt.text, validation::strict};
+            ppx::utf8::span const replace{tt.text, validation::replace};
+            ppx::utf8::span const skip{tt.text, validation::skip};
+            ASSERT_EQ(strict.error(), tt.error);
+            ASSERT_EQ(replace.error(), tt.error);
+            ASSERT_EQ(skip.error(), tt.error);
+
+            auto copy = replace;
+            ASSERT_EQ(copy().str(), tt.replace);
+            copy = strict;
+            ASSERT_EQ(copy().str(), tt.strict);
+            copy = skip;
+            ASSERT_EQ(copy().str(), tt.skip);
+        }
+
+        ppx::utf8::span span{"a\xff" "b", validation::replace};
+        ASSERT_TRUE(span.validated());
+        ASSERT_FALSE((ppx::utf8::span{"a\xff" "b", validation::none}.validated()));
+        ASSERT_EQ(span.next().str(), "a");
+        ASSERT_EQ(span.next().str(), "�");
+        ASSERT_EQ(span.next().str(), "b");
+        ASSERT_EQ(span.prev().str(), "b");
+        ASSERT_EQ(span.prev().str(), "�");
+
+        // valid text is owned too (the temporary is gone)
+        ppx::utf8::span valid{std::string{"Łódź"}, validation::replace};
+        ASSERT_EQ(valid().str(), "Łódź");
+        auto copy = valid;
+        ASSERT_TRUE(copy.validated());
+        copy.end();
+        ASSERT_EQ(copy.prev().str(), "ź");
+        copy.begin();
+        ASSERT_EQ(copy.next().str(), "Ł");
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::validation " << dt << '\n';
+}
+
+TEST_F(ScopeTest, lines) {
+    auto dt = executor([&] {
+        struct {
+            std::string text;
+            std::vector<std::string> expected;
+        } tests[] = {
+                {"",                   {}},
+                {"\n",                 {""}},
+                {"Łódź",               {"Łódź"}},
+                {"Łódź\nżnin\n",       {"Łódź", "żnin"}},
+                {"Łódź\r\n\r\nżnin",   {"Łódź", "", "żnin"}},
+                {"a\rb\n",             {"a\rb"}},
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::span const span{tt.text};
+            std::vector<std::string> result{};
+            for (auto const& line: ppx::utf8::lines{span}) {
+                ASSERT_EQ(line.len(), ppx::utf8::scope::codepoints(line().first, line.size()));
+                result.push_back(line.str());
+            }
+            ASSERT_EQ(result, tt.expected);
+        }
+        static_assert(std::ranges::input_range<ppx::utf8::lines>);
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::lines " << dt << '\n';
+}
+
+TEST_F(ScopeTest, fields) {
+    auto dt = executor([&] {
+        struct {
+            std::string text;
+            char delimiter;
+            char quote;
+            std::vector<std::string> expected;
+        } tests[] = {
+                {"",                          ',',  0,   {}},
+                {",",                         ',',  0,   {"", ""}},
+                {"Łódź\tżnin\t",              '\t', 0,   {"Łódź", "żnin", ""}},
+                {"a,\"b,c\",d",               ',',  '"', {"a", "b,c", "d"}},
+                {"a,\"b,c\",d",               ',',  0,   {"a", "\"b", "c\"", "d"}},
+                {"\"x \"\"y\"\"\",Straße",    ',',  '"', {"x \"\"y\"\"", "Straße"}},
+                {"\"open,field",              ',',  '"', {"open,field"}},
+                {"\"ab\"cd,e",                ',',  '"', {"ab\"cd", "e"}},    // bytes after closing quote
+                {"\"ab\" ",                   ',',  '"', {"ab\" "}},
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::span const span{tt.text};
+            std::vector<std::string> result{};
+            for (auto const& field: ppx::utf8::fields{span, tt.delimiter, tt.quote}) {
+                ASSERT_EQ(field.len(), ppx::utf8::scope::codepoints(field().first, field.size()));
+                result.push_back(field.str());
+            }
+            ASSERT_EQ(result, tt.expected);
+        }
+
+        std::string const tsv{"id\tmiasto\n1\tŁódź\n2\tŻnin\n"};
+        std::vector<int> lengths{};
+        for (auto const& line: ppx::utf8::lines{ppx::utf8::span{tsv}})
+            for (auto const& field: ppx::utf8::fields{line, '\t'})
+                lengths.push_back(field.len());
+        ASSERT_EQ(lengths, (std::vector<int>{2, 6, 1, 4, 1, 4}));
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::fields " << dt << '\n';
+}
+
+TEST_F(ScopeTest, transliterate) {
+    auto dt = executor([&] {
+        struct {
+            std::string text;
+            std::string expected;
+        } tests[] = {
+                {"",                   ""},
+                {"Łódź",               "Lodz"},
+                {"Straße",             "Strasse"},
+                {"ẞÄÖÜ äöü",           "SSAeOeUe aeoeue"},
+                {"Zażółć gęślą jaźń",  "Zazolc gesla jazn"},
+                {"日本 Łódź",            "日本 Lodz"},
+                {"abc\xc5",            "abc\xc5"},      // incomplete at the end
+                {"\xc5\xc5\x81x",       "\xc5Lx"},        // stray lead byte
+                {"\x81\xc3\xb6\xe2\x82x", "\x81oe\xe2\x82x"},   // stray continuation, truncated
+        };
+
+        for (auto const& tt: tests) {
+            ppx::utf8::span const span{tt.text};
+            auto const rv = span.transliterate();
+            ASSERT_EQ(std::string(rv.data(), rv.size()), tt.expected);
+
+            // the same, fed in chunks of every size
+            for (std::size_t chunk = 1; chunk <= 4; chunk++) {
+                ppx::utf8::transliterator tr{};
+                std::string result{};
+                char out[4 + 3];
+                for (std::size_t i = 0; i < tt.text.size(); i += chunk) {
+                    auto const n = std::min(chunk, tt.text.size() - i);
+                    result.append(out, tr.feed(tt.text.data() + i, n, out));
+                }
+                result.append(out, tr.finish(out));
+                ASSERT_EQ(result, tt.expected);
+            }
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::transliterate " << dt << '\n';
+}
+
+TEST_F(ScopeTest, stats) {
+    auto dt = executor([&] {
+        using ppx::utf8::stats;
+        auto const before = stats::thread();
+
+        ppx::utf8::span span{text_two_};
+        span.end();
+        while (span.prev().valid_chars());
+        auto const stepped = stats::thread();
+        span.begin();
+        (void) span.search(ppx::utf8::span{"k"}());
+        auto const searched = stats::thread();
+        (void) ppx::utf8::scope(text_two_.data(), int(text_two_.size()), 18).to_lower();
+        (void) ppx::utf8::scope(text_one_.data(), 7).hash();
+        auto const after = stats::thread();
+        std::string const sharp_s{"ß"};
+        (void) ppx::utf8::span{sharp_s}().to_upper();
+        auto const grown = stats::thread();
+
+        if constexpr (stats::enabled()) {
+            ASSERT_EQ(stepped.steps - before.steps, 18);
+            ASSERT_GE(searched.rewinds - stepped.rewinds, 1);
+            ASSERT_EQ(searched.candidates - stepped.candidates, 13);
+            ASSERT_EQ(after.allocated - searched.allocated, text_two_.size());
+            ASSERT_EQ(after.hashes - searched.hashes, 1);
+            // ß -> ẞ: reserve 2 bytes, grow past them, shrink to 3
+            ASSERT_GT(grown.allocated - after.allocated, 2 + 3);
+
+            auto total = stats::total();
+            ASSERT_GE(total.steps, after.steps);
+            std::vector<std::string_view> names{};
+            total.visit([&](std::string_view const name, stats::u64) { names.push_back(name); });
+            ASSERT_EQ(names.size(), 5);
+        } else {
+            ASSERT_EQ(after.steps, 0);
+            ASSERT_EQ(stats::total().hashes, 0);
+        }
+    });
+    std::cout.fill('.');
+    std::cout << std::setw(50) << std::left << "ScopeTest::stats " << dt << '\n';
+}
@@ -1,5 +1,7 @@
-#pragma one
+#pragma once
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iomanip>
 #include <string>
 #include <sstream>
 
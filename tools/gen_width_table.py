@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+# Generates width_table.h (terminal column width of code-points)
+# from the Unicode database shipped with Python:
+#   - zero width: combining marks (Mn, Me), format characters (Cf, except
+#     SOFT HYPHEN) and Hangul medial/final jamo,
+#   - double width: East Asian Wide (W) and Fullwidth (F) characters
+#     and unassigned code-points of the CJK planes 2 and 3.
+# Usage: python3 tools/gen_width_table.py > width_table.h
+import unicodedata
+
+
+def ranges(pred):
+    rv, first = [], None
+    for cp in range(0x110000 + 1):
+        hit = cp <= 0x10ffff and pred(cp)
+        if hit and first is None:
+            first = cp
+        elif not hit and first is not None:
+            rv.append((first, cp - 1))
+            first = None
+    return rv
+
+
+def zero(cp):
+    if cp == 0x00ad:
+        return False
+    if 0x1160 <= cp <= 0x11ff or 0xd7b0 <= cp <= 0xd7ff:
+        return True
+    return unicodedata.category(chr(cp)) in ('Mn', 'Me', 'Cf')
+
+
+def wide(cp):
+    if zero(cp):
+        return False
+    if 0x20000 <= cp <= 0x2fffd or 0x30000 <= cp <= 0x3fffd:
+        return True
+    return unicodedata.east_asian_width(chr(cp)) in ('W', 'F')
+
+
+def table(name, rs):
+    print(f'    constexpr range {name}[] {{')
+    for a, b in rs:
+        print(f'            {{0x{a:05x}, 0x{b:05x}}},')
+    print('    };')
+
+
+print(f'// Generated by tools/gen_width_table.py (Unicode {unicodedata.unidata_version}). Do not edit.')
+print('#pragma once')
+print('#include "scope.h"')
+print()
+print('namespace ppx::utf8::width_table {')
+print('    struct range {')
+print('        u32 first;')
+print('        u32 last;')
+print('    };')
+print()
+table('Zero', ranges(zero))
+print()
+table('Wide', ranges(wide))
+print('}')
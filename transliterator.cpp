@@ -0,0 +1,41 @@
+#include "transliterator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ppx::utf8 {
+    std::size_t transliterator::
+    feed(char const *ptr, std::size_t size, char *const out) noexcept {
+        std::size_t written = 0;
+        if (pending_ > 0) {
+            // complete the code-point started in previous chunk
+            auto const need = scope::codepoint_size(carry_);
+            while (pending_ < need && size > 0 && scope::is_continuation(*ptr)) {
+                carry_[pending_++] = *ptr++;
+                size--;
+            }
+            if (pending_ < need && size == 0)
+                return 0;
+            if (pending_ == need)
+                written = scope::transliterate(carry_, pending_, out).second;
+            else {
+                // it will never be completed - invalid bytes are copied
+                std::memcpy(out, carry_, pending_);
+                written = pending_;
+            }
+            pending_ = 0;
+        }
+
+        auto const [consumed, n] = scope::transliterate(ptr, size, out + written);
+        pending_ = uint(size - consumed);
+        std::memcpy(carry_, ptr + consumed, pending_);
+        return written + n;
+    }
+
+    std::size_t transliterator::
+    finish(char *const out) noexcept {
+        auto const n = pending_;
+        std::memcpy(out, carry_, n);
+        pending_ = 0;
+        return n;
+    }
+}
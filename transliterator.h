@@ -0,0 +1,24 @@
+#pragma once
+
+#include "scope.h"
+#include <cstddef>
+
+namespace ppx::utf8 {
+
+    /// Streaming transliteration (see scope::transliterate). \n
+    /// Code-point split between chunks is kept until the next chunk arrives.
+    class transliterator {
+        char carry_[4]{};       // beginning of incomplete code-point
+        uint pending_{};        // number of bytes in carry
+    public:
+        /// Transliterates next chunk of the stream.
+        /// \param out - buffer for at least size + 3 bytes.
+        /// \return number of bytes written.
+        std::size_t feed(char const *ptr, std::size_t size, char *out) noexcept;
+
+        /// Flushes incomplete code-point at the end of stream (copied as it is).
+        /// \param out - buffer for at least 3 bytes.
+        /// \return number of bytes written.
+        std::size_t finish(char *out) noexcept;
+    };
+}
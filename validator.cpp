@@ -0,0 +1,83 @@
+#include "validator.h"
+#include "ascii.h"
+
+namespace ppx::utf8 {
+    // Well-formed sequences (Unicode 15, table 3-7).
+    int validator::
+    sequence(char const *const ptr, char const *const sentinel) noexcept {
+        auto const c = static_cast<u8>(ptr[0]);
+        if (c < 0x80)
+            return 1;
+
+        int n;
+        u8 lo = 0x80;
+        u8 hi = 0xbf;
+        if (c >= 0xc2 && c <= 0xdf)
+            n = 2;
+        else if (c >= 0xe0 && c <= 0xef) {
+            n = 3;
+            if (c == 0xe0) lo = 0xa0;       // overlong
+            else if (c == 0xed) hi = 0x9f;  // surrogates
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            n = 4;
+            if (c == 0xf0) lo = 0x90;       // overlong
+            else if (c == 0xf4) hi = 0x8f;  // above U+10FFFF
+        } else
+            return -1;
+
+        for (int i = 1; i < n; i++) {
+            if (ptr + i >= sentinel)
+                return -i;
+            auto const b = static_cast<u8>(ptr[i]);
+            if (b < lo || b > hi)
+                return -i;
+            lo = 0x80;
+            hi = 0xbf;
+        }
+        return n;
+    }
+
+    std::size_t validator::
+    first_invalid(char const *const ptr, std::size_t const size) noexcept {
+        auto const sentinel = ptr + size;
+        auto p = ptr;
+        while (p < sentinel) {
+            p += ascii::prefix(p, sentinel - p);
+            if (p >= sentinel)
+                break;
+            auto const n = sequence(p, sentinel);
+            if (n < 0)
+                return p - ptr;
+            p += n;
+        }
+        return size;
+    }
+
+    std::string validator::
+    repair(char const *const ptr, std::size_t const size, std::string_view const replacement,
+           std::size_t const valid) {
+        std::string rv;
+        rv.reserve(size);
+        auto capacity = rv.capacity();
+        UTF8SPAN_COUNT(allocated, capacity);
+
+        auto const sentinel = ptr + size;
+        rv.append(ptr, valid);
+        auto p = ptr + valid;
+        while (p < sentinel) {
+            auto const n = first_invalid(p, sentinel - p);
+            rv.append(p, n);
+            p += n;
+            if (p < sentinel) {
+                rv.append(replacement);
+                p -= sequence(p, sentinel);
+            }
+            // replacements can grow the text (up to 3x)
+            if (rv.capacity() != capacity) {
+                capacity = rv.capacity();
+                UTF8SPAN_COUNT(allocated, capacity);
+            }
+        }
+        return rv;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "scope.h"
+#include <string>
+#include <string_view>
+
+namespace ppx::utf8 {
+
+    /// How span treats invalid utf8 (overlongs, surrogates, stray
+    /// continuation bytes, truncated sequences).
+    enum class validation {
+        none,       // no checks, bytes are used as they are
+        strict,     // span ends before the first invalid byte
+        replace,    // every invalid sequence becomes U+FFFD
+        skip,       // invalid sequences are dropped
+    };
+
+    class validator {
+    public:
+        /// UTF-8 encoded U+FFFD (REPLACEMENT CHARACTER).
+        static constexpr std::string_view Replacement{"\xef\xbf\xbd"};
+
+        /// Checks sequence at ptr.
+        /// \return number of bytes of valid code-point (1..4) or,
+        ///         for invalid sequence, minus length of its maximal subpart.
+        static int sequence(char const *ptr, char const *sentinel) noexcept;
+
+        /// Returns offset of first invalid byte (size if whole buffer is valid).
+        /// ASCII runs are skipped 8 bytes at a time.
+        static std::size_t first_invalid(char const *ptr, std::size_t size) noexcept;
+
+        /// Returns copy of buffer with every invalid sequence (maximal subpart)
+        /// substituted by passed replacement (empty replacement drops it).
+        /// \param valid - length of leading part known to be valid (copied without checks),
+        ///        e.g. result of first_invalid.
+        static std::string repair(char const *ptr, std::size_t size, std::string_view replacement,
+                                  std::size_t valid = 0);
+    };
+}